@@ -0,0 +1,353 @@
+#include "Analyze.h"
+#include "Board.h"
+#include "Search.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Lines per unit of work. Small enough to balance uneven positions,
+// large enough that queue locking is rare.
+static const int CHUNK_LINES = 32;
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+private:
+    const char* data;
+    std::size_t length;
+
+public:
+    MappedFile() : data(nullptr), length(0) {}
+    ~MappedFile()
+    {
+        if (data != nullptr)
+        {
+            munmap(const_cast<char*>(data), length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; false (with errno set) if it cannot be opened or mapped
+    bool open(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0)
+        {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(fd);
+                length = 0;
+                return false;
+            }
+            data = static_cast<const char*>(mapped);
+            madvise(mapped, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);  // The mapping stays valid after the descriptor is closed
+        return true;
+    }
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    std::size_t size() const { return length; }
+};
+
+// A run of whole lines in the mapped file
+struct Chunk
+{
+    const char* begin;
+    const char* end;
+    uint64_t firstLine;  // 1-based line number of begin
+};
+
+// One worker's chunks. The owner takes from the front; thieves take from
+// the back, so they pick up the work the owner would reach last.
+class WorkQueue
+{
+private:
+    std::mutex mutex;
+    std::deque<Chunk> chunks;
+
+public:
+    void push(const Chunk& chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks.push_back(chunk);
+    }
+
+    bool popFront(Chunk& chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunks.empty())
+        {
+            return false;
+        }
+        chunk = chunks.front();
+        chunks.pop_front();
+        return true;
+    }
+
+    bool stealBack(Chunk& chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chunks.empty())
+        {
+            return false;
+        }
+        chunk = chunks.back();
+        chunks.pop_back();
+        return true;
+    }
+};
+
+// Settings for one analyze run
+struct AnalyzeOptions
+{
+    std::string input;
+    SearchLimits limits;
+    int threads;
+    int hashMB;  // Per worker
+
+    AnalyzeOptions() : threads(1), hashMB(16)
+    {
+        limits.depth = 4;
+    }
+};
+
+// Totals gathered from every worker
+struct AnalyzeTotals
+{
+    std::atomic<uint64_t> positions;
+    std::atomic<uint64_t> nodes;
+    std::atomic<uint64_t> invalid;
+
+    AnalyzeTotals() : positions(0), nodes(0), invalid(0) {}
+};
+
+// Cut the file into chunks of CHUNK_LINES lines, dealt out to the queues
+// in contiguous blocks so each worker starts on its own stretch of the file
+static std::size_t splitIntoChunks(const MappedFile& file, std::vector<std::unique_ptr<WorkQueue>>& queues)
+{
+    std::vector<Chunk> chunks;
+    const char* p = file.begin();
+    const char* end = file.end();
+    uint64_t line = 1;
+    while (p < end)
+    {
+        Chunk chunk;
+        chunk.begin = p;
+        chunk.firstLine = line;
+        for (int i = 0; i < CHUNK_LINES && p < end; i++)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            p = (newline != nullptr) ? newline + 1 : end;
+            line++;
+        }
+        chunk.end = p;
+        chunks.push_back(chunk);
+    }
+
+    std::size_t perQueue = (chunks.size() + queues.size() - 1) / queues.size();
+    for (std::size_t i = 0; i < chunks.size(); i++)
+    {
+        queues[i / perQueue]->push(chunks[i]);
+    }
+    return chunks.size();
+}
+
+// Write one finished line to stdout
+static void writeResult(std::mutex& outputMutex, const char* text, int length)
+{
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::fwrite(text, 1, length, stdout);
+    std::fflush(stdout);
+}
+
+// Analyze every position in a chunk
+static void analyzeChunk(const Chunk& chunk, Search& search, const SearchLimits& limits,
+                         AnalyzeTotals& totals, std::mutex& outputMutex)
+{
+    Board board;
+    uint64_t line = chunk.firstLine;
+    const char* p = chunk.begin;
+    while (p < chunk.end)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        const char* lineEnd = (newline != nullptr) ? newline : chunk.end;
+        std::string_view text(p, lineEnd - p);
+        p = (newline != nullptr) ? newline + 1 : chunk.end;
+        uint64_t lineNumber = line++;
+
+        // Skip blank lines and comments
+        std::size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos || text[first] == '#')
+        {
+            continue;
+        }
+
+        char buffer[128];
+        int length;
+        if (!board.fromFEN(text))
+        {
+            totals.invalid++;
+            length = std::snprintf(buffer, sizeof(buffer), "%llu invalid\n",
+                                   static_cast<unsigned long long>(lineNumber));
+        }
+        else
+        {
+            SearchResult result = search.think(board, board.sideToMove(), limits);
+            totals.positions++;
+            totals.nodes += result.nodes;
+            std::string move = (result.bestMove.fromRow < 0) ? "0000" : Board::moveToString(result.bestMove);
+            length = std::snprintf(buffer, sizeof(buffer), "%llu %s %d %llu %d\n",
+                                   static_cast<unsigned long long>(lineNumber), move.c_str(),
+                                   result.score, static_cast<unsigned long long>(result.nodes),
+                                   result.depth);
+        }
+        writeResult(outputMutex, buffer, length);
+    }
+}
+
+// Work through our own queue, then steal from the others until all are empty
+static void runWorker(std::size_t index, std::vector<std::unique_ptr<WorkQueue>>& queues,
+                      const AnalyzeOptions& options, AnalyzeTotals& totals, std::mutex& outputMutex)
+{
+    TranspositionTable table(options.hashMB);
+    Search search(table);
+
+    Chunk chunk;
+    for (;;)
+    {
+        bool found = queues[index]->popFront(chunk);
+        for (std::size_t i = 1; !found && i < queues.size(); i++)
+        {
+            found = queues[(index + i) % queues.size()]->stealBack(chunk);
+        }
+        if (!found)
+        {
+            return;  // Chunks are never added after the start, so we are done
+        }
+        analyzeChunk(chunk, search, options.limits, totals, outputMutex);
+    }
+}
+
+// Print usage for the analyze subcommand
+static void printAnalyzeUsage()
+{
+    std::cerr << "Usage: chess_game analyze --input FILE [--threads N] [--depth D] [--movetime MS] [--hash MB]\n"
+              << "  FILE holds one FEN or EPD position per line\n"
+              << "  Output: <line> <bestmove> <score> <nodes> <depth> per position\n";
+}
+
+// Entry point for "chess_game analyze ..."
+int runAnalyzeCommand(const std::vector<std::string>& args)
+{
+    AnalyzeOptions options;
+    unsigned int hardware = std::thread::hardware_concurrency();
+    options.threads = hardware > 0 ? static_cast<int>(hardware) : 1;
+    bool depthGiven = false;
+
+    for (std::size_t i = 0; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--input" && hasValue)
+            options.input = args[++i];
+        else if (arg == "--threads" && hasValue)
+            options.threads = std::max(1, std::atoi(args[++i].c_str()));
+        else if (arg == "--depth" && hasValue)
+        {
+            options.limits.depth = std::max(1, std::atoi(args[++i].c_str()));
+            depthGiven = true;
+        }
+        else if (arg == "--movetime" && hasValue)
+            options.limits.moveTime = std::max(1, std::atoi(args[++i].c_str()));
+        else if (arg == "--hash" && hasValue)
+            options.hashMB = std::max(1, std::atoi(args[++i].c_str()));
+        else
+        {
+            printAnalyzeUsage();
+            return 1;
+        }
+    }
+    if (options.input.empty())
+    {
+        printAnalyzeUsage();
+        return 1;
+    }
+
+    // With a time budget the depth is only a cap if it was asked for
+    if (options.limits.isTimed() && !depthGiven)
+    {
+        options.limits.depth = 0;
+    }
+
+    MappedFile file;
+    if (!file.open(options.input))
+    {
+        std::cerr << "Cannot read " << options.input << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (int i = 0; i < options.threads; i++)
+    {
+        queues.emplace_back(new WorkQueue());
+    }
+    splitIntoChunks(file, queues);
+
+    AnalyzeTotals totals;
+    std::mutex outputMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < queues.size(); i++)
+    {
+        workers.emplace_back(runWorker, i, std::ref(queues), std::cref(options),
+                             std::ref(totals), std::ref(outputMutex));
+    }
+    for (std::thread& t : workers)
+    {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t positions = totals.positions.load();
+    std::cerr << "Analyzed " << positions << " positions";
+    if (totals.invalid > 0)
+    {
+        std::cerr << " (" << totals.invalid.load() << " invalid lines skipped)";
+    }
+    std::cerr << " in " << seconds << " s with " << options.threads << " threads\n"
+              << "Positions/s: " << (seconds > 0 ? positions / seconds : 0.0)
+              << "  NPS: " << (seconds > 0 ? totals.nodes.load() / seconds : 0.0) << "\n";
+    return 0;
+}
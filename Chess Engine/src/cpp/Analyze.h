@@ -0,0 +1,23 @@
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include <string>
+#include <vector>
+
+// Batch analysis of an EPD/FEN file ("chess_game analyze ...").
+//
+// The file is memory-mapped and cut into chunks of lines. Each worker
+// thread owns a queue of chunks and its own Search and transposition
+// table; a worker whose queue runs dry steals chunks from the back of
+// another worker's queue. For every position one line is written as soon
+// as it is finished:
+//
+//     <line number> <best move> <score> <nodes> <depth>
+//
+// Results appear in completion order, not file order; the line number ties
+// each one back to its input. Throughput goes to stderr at the end.
+
+// Entry point for "chess_game analyze ..."; returns the process exit code
+int runAnalyzeCommand(const std::vector<std::string>& args);
+
+#endif // ANALYZE_H
@@ -0,0 +1,166 @@
+#include "Bitboard.h"
+#include <mutex>
+#include <vector>
+
+Bitboard Attacks::knightTable[64];
+Bitboard Attacks::kingTable[64];
+Bitboard Attacks::pawnTable[2][64];
+Attacks::Magic Attacks::rookMagics[64];
+Attacks::Magic Attacks::bishopMagics[64];
+
+// Shared storage for every square's slider attacks
+static Bitboard rookAttackTable[0x19000];
+static Bitboard bishopAttackTable[0x1480];
+
+static const int ROOK_DIRS[4][2]   = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+static const int BISHOP_DIRS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+// Walks each ray until it leaves the board or hits a blocker (blocker included)
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int dirs[4][2])
+{
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++)
+    {
+        int row = rowOf(square) + dirs[d][0];
+        int col = colOf(square) + dirs[d][1];
+        while (row >= 0 && row < 8 && col >= 0 && col < 8)
+        {
+            Bitboard bit = squareBit(squareOf(row, col));
+            attacks |= bit;
+            if (occupied & bit)
+            {
+                break;
+            }
+            row += dirs[d][0];
+            col += dirs[d][1];
+        }
+    }
+    return attacks;
+}
+
+// Attacks of a leaper given as a list of (row, col) offsets
+static Bitboard leaperAttacks(int square, const int offsets[][2], int count)
+{
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int row = rowOf(square) + offsets[i][0];
+        int col = colOf(square) + offsets[i][1];
+        if (row >= 0 && row < 8 && col >= 0 && col < 8)
+        {
+            attacks |= squareBit(squareOf(row, col));
+        }
+    }
+    return attacks;
+}
+
+// Small xorshift generator; a fixed seed keeps the magics reproducible
+static uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+// Fills one slider's Magic entries and attack table ("fancy" magic bitboards)
+static void initSliders(Attacks::Magic magics[64], Bitboard* table, const int dirs[4][2])
+{
+    uint64_t seed = 728;
+    std::vector<Bitboard> occupancies;
+    std::vector<Bitboard> references;
+    std::vector<int> epoch;
+    int attempt = 0;
+    std::size_t offset = 0;
+
+    for (int square = 0; square < 64; square++)
+    {
+        Attacks::Magic& m = magics[square];
+
+        // Board edges never block a ray, so they are left out of the mask
+        Bitboard rank1 = 0xFFULL, rank8 = 0xFFULL << 56;
+        Bitboard fileA = 0x0101010101010101ULL, fileH = fileA << 7;
+        Bitboard edges = ((rank1 | rank8) & ~(rank1 << (8 * rowOf(square))))
+                       | ((fileA | fileH) & ~(fileA << colOf(square)));
+
+        m.mask = slidingAttacks(square, 0, dirs) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.table = table + offset;
+
+        // Enumerate every subset of the mask (Carry-Rippler) with its attacks
+        occupancies.clear();
+        references.clear();
+        Bitboard subset = 0;
+        do
+        {
+            occupancies.push_back(subset);
+            references.push_back(slidingAttacks(square, subset, dirs));
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        std::size_t size = occupancies.size();
+        offset += size;
+
+#ifdef USE_PEXT
+        // PEXT is a perfect hash: no magic search needed
+        m.magic = 0;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            m.table[m.index(occupancies[i])] = references[i];
+        }
+#else
+        // Try sparse random multipliers until no two subsets with different
+        // attacks land on the same slot
+        epoch.assign(size, 0);
+        std::size_t i = 0;
+        while (i < size)
+        {
+            do
+            {
+                m.magic = nextRandom(seed) & nextRandom(seed) & nextRandom(seed);
+            } while (popCount((m.mask * m.magic) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; i++)
+            {
+                unsigned idx = m.index(occupancies[i]);
+                if (epoch[idx] < attempt)
+                {
+                    epoch[idx] = attempt;
+                    m.table[idx] = references[i];
+                }
+                else if (m.table[idx] != references[i])
+                {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+// Builds every attack table exactly once
+void Attacks::init()
+{
+    static std::once_flag once;
+    std::call_once(once, []()
+    {
+        static const int KNIGHT_OFFSETS[8][2] =
+            { {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+        static const int KING_OFFSETS[8][2] =
+            { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+        static const int WHITE_PAWN_OFFSETS[2][2] = { {1, 1}, {1, -1} };
+        static const int BLACK_PAWN_OFFSETS[2][2] = { {-1, 1}, {-1, -1} };
+
+        for (int square = 0; square < 64; square++)
+        {
+            knightTable[square] = leaperAttacks(square, KNIGHT_OFFSETS, 8);
+            kingTable[square] = leaperAttacks(square, KING_OFFSETS, 8);
+            pawnTable[0][square] = leaperAttacks(square, WHITE_PAWN_OFFSETS, 2);
+            pawnTable[1][square] = leaperAttacks(square, BLACK_PAWN_OFFSETS, 2);
+        }
+
+        initSliders(rookMagics, rookAttackTable, ROOK_DIRS);
+        initSliders(bishopMagics, bishopAttackTable, BISHOP_DIRS);
+    });
+}
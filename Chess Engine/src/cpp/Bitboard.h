@@ -0,0 +1,94 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "Board.h"
+#include <cstdint>
+
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+
+// One bit per square, bit index = row * 8 + col (a1 = 0, h8 = 63)
+using Bitboard = uint64_t;
+
+// Square index helpers
+inline int squareOf(int row, int col) { return row * 8 + col; }
+inline int rowOf(int square) { return square >> 3; }
+inline int colOf(int square) { return square & 7; }
+inline Bitboard squareBit(int square) { return Bitboard(1) << square; }
+
+// Bit twiddling helpers
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lowestSquare(Bitboard b) { return __builtin_ctzll(b); }
+
+// Returns the lowest set square and clears it from b
+inline int popLowestSquare(Bitboard& b)
+{
+    int square = __builtin_ctzll(b);
+    b &= b - 1;
+    return square;
+}
+
+// Index of a color / piece type in per-side arrays
+inline int colorIndex(Color color) { return color == Color::WHITE ? 0 : 1; }
+inline int typeIndex(PieceType type) { return static_cast<int>(type) - 1; }
+inline Color opposite(Color color) { return color == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+// Precomputed attack sets for every piece type.
+// Slider attacks use magic bitboards, or PEXT when built with -DUSE_PEXT
+// on a BMI2 machine. init() must run before the first lookup; it is cheap
+// to call again.
+class Attacks
+{
+public:
+    // Per-square slider lookup: relevant occupancy mask plus a slice of the
+    // shared attack table
+    struct Magic
+    {
+        Bitboard mask;
+        Bitboard magic;
+        Bitboard* table;
+        unsigned shift;
+
+        unsigned index(Bitboard occupied) const
+        {
+#ifdef USE_PEXT
+            return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+        }
+    };
+
+    static void init();
+
+    static Bitboard knight(int square) { return knightTable[square]; }
+    static Bitboard king(int square) { return kingTable[square]; }
+    static Bitboard pawn(Color color, int square) { return pawnTable[colorIndex(color)][square]; }
+
+    static Bitboard rook(int square, Bitboard occupied)
+    {
+        const Magic& m = rookMagics[square];
+        return m.table[m.index(occupied)];
+    }
+
+    static Bitboard bishop(int square, Bitboard occupied)
+    {
+        const Magic& m = bishopMagics[square];
+        return m.table[m.index(occupied)];
+    }
+
+    static Bitboard queen(int square, Bitboard occupied)
+    {
+        return rook(square, occupied) | bishop(square, occupied);
+    }
+
+private:
+    static Bitboard knightTable[64];
+    static Bitboard kingTable[64];
+    static Bitboard pawnTable[2][64];
+    static Magic rookMagics[64];
+    static Magic bishopMagics[64];
+};
+
+#endif // BITBOARD_H
@@ -0,0 +1,471 @@
+#include "BitboardBoard.h"
+#include <algorithm>
+
+static const Bitboard RANK_1 = 0x00000000000000FFULL;
+static const Bitboard RANK_3 = 0x0000000000FF0000ULL;
+static const Bitboard RANK_6 = 0x0000FF0000000000ULL;
+static const Bitboard RANK_8 = 0xFF00000000000000ULL;
+
+// Constructor - empty board
+BitboardBoard::BitboardBoard()
+    : pieces{}, occupancy{}, occupied(0), castling(0), enPassant(-1)
+{
+    Attacks::init();
+}
+
+// Constructor - copy the position of a Board
+BitboardBoard::BitboardBoard(const Board& board)
+    : BitboardBoard()
+{
+    load(board);
+}
+
+// Rebuild every mask from the Board's piece lists
+void BitboardBoard::load(const Board& board)
+{
+    for (int c = 0; c < 2; c++)
+    {
+        Color color = (c == 0) ? Color::WHITE : Color::BLACK;
+        occupancy[c] = 0;
+        for (int t = 0; t < 6; t++)
+        {
+            PieceType type = static_cast<PieceType>(t + 1);
+            const uint8_t* list = board.pieceSquares(color, type);
+            Bitboard mask = 0;
+            for (int i = 0; i < board.pieceCount(color, type); i++)
+            {
+                mask |= squareBit(list[i]);
+            }
+            pieces[c][t] = mask;
+            occupancy[c] |= mask;
+        }
+    }
+    occupied = occupancy[0] | occupancy[1];
+    castling = board.castlingRights();
+    enPassant = board.enPassantSquare();
+}
+
+// Find which piece (if any) stands on a square
+Piece BitboardBoard::pieceAt(int square) const
+{
+    Bitboard bit = squareBit(square);
+    for (int c = 0; c < 2; c++)
+    {
+        if (!(occupancy[c] & bit))
+        {
+            continue;
+        }
+        for (int t = 0; t < 6; t++)
+        {
+            if (pieces[c][t] & bit)
+            {
+                return Piece(static_cast<PieceType>(t + 1), c == 0 ? Color::WHITE : Color::BLACK);
+            }
+        }
+    }
+    return Piece();
+}
+
+// Check if any piece of byColor attacks the square
+bool BitboardBoard::isSquareAttacked(int square, Color byColor) const
+{
+    const Bitboard* them = pieces[colorIndex(byColor)];
+
+    // A pawn of byColor attacks the square if a pawn of the other color
+    // standing there would attack the pawn
+    if (Attacks::pawn(opposite(byColor), square) & them[typeIndex(PieceType::PAWN)])
+        return true;
+    if (Attacks::knight(square) & them[typeIndex(PieceType::KNIGHT)])
+        return true;
+    if (Attacks::king(square) & them[typeIndex(PieceType::KING)])
+        return true;
+
+    Bitboard queens = them[typeIndex(PieceType::QUEEN)];
+    if (Attacks::rook(square, occupied) & (them[typeIndex(PieceType::ROOK)] | queens))
+        return true;
+    if (Attacks::bishop(square, occupied) & (them[typeIndex(PieceType::BISHOP)] | queens))
+        return true;
+
+    return false;
+}
+
+// A side is in check if its king is attacked (no king means no check)
+bool BitboardBoard::isInCheck(Color color) const
+{
+    Bitboard king = piecesOf(color, PieceType::KING);
+    if (!king)
+    {
+        return false;
+    }
+    return isSquareAttacked(lowestSquare(king), opposite(color));
+}
+
+// Remove whatever piece stands on a square
+static void clearSquare(Bitboard pieces[2][6], Bitboard occupancy[2], int square)
+{
+    Bitboard bit = squareBit(square);
+    for (int c = 0; c < 2; c++)
+    {
+        if (occupancy[c] & bit)
+        {
+            for (int t = 0; t < 6; t++)
+            {
+                pieces[c][t] &= ~bit;
+            }
+            occupancy[c] &= ~bit;
+        }
+    }
+}
+
+// Move a piece, removing any captured piece
+void BitboardBoard::applyMove(const PackedMove& move)
+{
+    int from = move.from();
+    int to = move.to();
+    Bitboard fromBit = squareBit(from);
+    Bitboard toBit = squareBit(to);
+    int us = (occupancy[0] & fromBit) ? 0 : 1;
+
+    // En passant takes the pawn behind the destination
+    if (move.flags() == PackedMove::EN_PASSANT)
+    {
+        clearSquare(pieces, occupancy, us == 0 ? to - 8 : to + 8);
+    }
+    else if (move.isCapture())
+    {
+        clearSquare(pieces, occupancy, to);
+    }
+
+    for (int t = 0; t < 6; t++)
+    {
+        if (pieces[us][t] & fromBit)
+        {
+            pieces[us][t] ^= fromBit;
+            int placed = move.isPromotion() ? typeIndex(move.promotionType()) : t;
+            pieces[us][placed] ^= toBit;
+            break;
+        }
+    }
+    occupancy[us] ^= fromBit | toBit;
+
+    // Castling: the rook jumps to the square the king passed over
+    if (move.flags() == PackedMove::KING_CASTLE || move.flags() == PackedMove::QUEEN_CASTLE)
+    {
+        bool kingside = move.flags() == PackedMove::KING_CASTLE;
+        Bitboard rookBits = squareBit(kingside ? to + 1 : to - 2) | squareBit(kingside ? to - 1 : to + 1);
+        pieces[us][typeIndex(PieceType::ROOK)] ^= rookBits;
+        occupancy[us] ^= rookBits;
+    }
+    occupied = occupancy[0] | occupancy[1];
+
+    castling = 0;
+    enPassant = -1;
+}
+
+// Calls visit for every move from one square to a set of target squares
+template <typename Visit>
+static void visitTargets(int from, Bitboard targets, Bitboard enemy, Visit& visit)
+{
+    while (targets)
+    {
+        int to = popLowestSquare(targets);
+        visit(PackedMove(from, to, (enemy & squareBit(to)) ? PackedMove::CAPTURE : PackedMove::QUIET));
+    }
+}
+
+// Calls visit for the four promotions of a pawn move to the last rank,
+// queen first
+template <typename Visit>
+static void visitPromotions(int from, int to, bool capture, Visit& visit)
+{
+    int base = capture ? PackedMove::PROMOTION_CAPTURE : PackedMove::PROMOTION;
+    for (int piece = 3; piece >= 0; piece--)
+    {
+        visit(PackedMove(from, to, base + piece));
+    }
+}
+
+// Pseudo-legal moves: piece movement rules only, king safety ignored
+// (except that castling never starts from, passes or lands on an attacked
+// square). With CapturesOnly, pawn pushes, quiet piece moves and castling
+// are skipped.
+template <bool CapturesOnly, typename Visit>
+void BitboardBoard::forEachPseudoLegalMove(Color color, Visit visit) const
+{
+    const Bitboard* us = pieces[colorIndex(color)];
+    Bitboard enemy = occupancy[colorIndex(opposite(color))];
+    Bitboard own = occupancy[colorIndex(color)];
+    Bitboard allowed = CapturesOnly ? enemy : ~own;  // Squares a piece may land on
+    Bitboard empty = CapturesOnly ? 0 : ~occupied;   // No pawn pushes when capturing only
+
+    // Pawns: single push, double push from the starting rank, diagonal
+    // captures, en passant. Moves to the last rank promote.
+    Bitboard pawns = us[typeIndex(PieceType::PAWN)];
+    Bitboard lastRank = (color == Color::WHITE) ? RANK_8 : RANK_1;
+    int forward = (color == Color::WHITE) ? 8 : -8;
+    Bitboard singles = (color == Color::WHITE) ? (pawns << 8) & empty : (pawns >> 8) & empty;
+    Bitboard doubles = (color == Color::WHITE) ? ((singles & RANK_3) << 8) & empty
+                                               : ((singles & RANK_6) >> 8) & empty;
+    while (singles)
+    {
+        int to = popLowestSquare(singles);
+        if (squareBit(to) & lastRank)
+        {
+            visitPromotions(to - forward, to, false, visit);
+        }
+        else
+        {
+            visit(PackedMove(to - forward, to));
+        }
+    }
+    while (doubles)
+    {
+        int to = popLowestSquare(doubles);
+        visit(PackedMove(to - 2 * forward, to, PackedMove::DOUBLE_PUSH));
+    }
+    if (enPassant >= 0)
+    {
+        // Our pawns standing where an enemy pawn on the square would attack
+        Bitboard takers = Attacks::pawn(opposite(color), enPassant) & pawns;
+        while (takers)
+        {
+            visit(PackedMove(popLowestSquare(takers), enPassant, PackedMove::EN_PASSANT));
+        }
+    }
+    while (pawns)
+    {
+        int from = popLowestSquare(pawns);
+        Bitboard targets = Attacks::pawn(color, from) & enemy;
+        if (targets & lastRank)
+        {
+            while (targets)
+            {
+                visitPromotions(from, popLowestSquare(targets), true, visit);
+            }
+        }
+        else
+        {
+            visitTargets(from, targets, enemy, visit);
+        }
+    }
+    // Knights
+    Bitboard knights = us[typeIndex(PieceType::KNIGHT)];
+    while (knights)
+    {
+        int from = popLowestSquare(knights);
+        visitTargets(from, Attacks::knight(from) & allowed, enemy, visit);
+    }
+
+    // Bishops and queens along diagonals, rooks and queens along lines
+    Bitboard queens = us[typeIndex(PieceType::QUEEN)];
+    Bitboard diagonal = us[typeIndex(PieceType::BISHOP)] | queens;
+    while (diagonal)
+    {
+        int from = popLowestSquare(diagonal);
+        Bitboard targets = Attacks::bishop(from, occupied);
+        if (queens & squareBit(from))
+        {
+            targets |= Attacks::rook(from, occupied);
+        }
+        visitTargets(from, targets & allowed, enemy, visit);
+    }
+    Bitboard straight = us[typeIndex(PieceType::ROOK)];
+    while (straight)
+    {
+        int from = popLowestSquare(straight);
+        visitTargets(from, Attacks::rook(from, occupied) & allowed, enemy, visit);
+    }
+
+    // King
+    Bitboard king = us[typeIndex(PieceType::KING)];
+    while (king)
+    {
+        int from = popLowestSquare(king);
+        visitTargets(from, Attacks::king(from) & allowed, enemy, visit);
+    }
+
+    // Castling: king and rook on their home squares with the rights kept,
+    // nothing between them, and the king not in, through or into check
+    if (CapturesOnly || !castling)
+    {
+        return;
+    }
+    bool white = (color == Color::WHITE);
+    int home = white ? 4 : 60;
+    uint8_t kingside = white ? Board::WHITE_KINGSIDE : Board::BLACK_KINGSIDE;
+    uint8_t queenside = white ? Board::WHITE_QUEENSIDE : Board::BLACK_QUEENSIDE;
+    Bitboard rooks = us[typeIndex(PieceType::ROOK)];
+    Color them = opposite(color);
+    if (!(us[typeIndex(PieceType::KING)] & squareBit(home)) || isSquareAttacked(home, them))
+    {
+        return;
+    }
+    if ((castling & kingside) && (rooks & squareBit(home + 3)) &&
+        !(occupied & (squareBit(home + 1) | squareBit(home + 2))) &&
+        !isSquareAttacked(home + 1, them) && !isSquareAttacked(home + 2, them))
+    {
+        visit(PackedMove(home, home + 2, PackedMove::KING_CASTLE));
+    }
+    if ((castling & queenside) && (rooks & squareBit(home - 4)) &&
+        !(occupied & (squareBit(home - 1) | squareBit(home - 2) | squareBit(home - 3))) &&
+        !isSquareAttacked(home - 1, them) && !isSquareAttacked(home - 2, them))
+    {
+        visit(PackedMove(home, home - 2, PackedMove::QUEEN_CASTLE));
+    }
+}
+
+// True if making the move leaves our king safe
+bool BitboardBoard::leavesKingSafe(Color color, const PackedMove& move) const
+{
+    BitboardBoard next = *this;
+    next.applyMove(move);
+    return !next.isInCheck(color);
+}
+
+// Keep only the pseudo-legal moves that leave our king safe
+void BitboardBoard::generateLegalMoves(Color color, MoveList& moves) const
+{
+    forEachPseudoLegalMove<false>(color, [&](const PackedMove& m)
+    {
+        if (leavesKingSafe(color, m))
+        {
+            moves.add(m);
+        }
+    });
+}
+
+// Legal captures only, for the quiescence search
+void BitboardBoard::generateLegalCaptures(Color color, MoveList& moves) const
+{
+    forEachPseudoLegalMove<true>(color, [&](const PackedMove& m)
+    {
+        if (leavesKingSafe(color, m))
+        {
+            moves.add(m);
+        }
+    });
+}
+
+// Check if the side has at least one legal move
+bool BitboardBoard::hasLegalMove(Color color) const
+{
+    // Stop testing king safety once one legal move is found
+    bool found = false;
+    forEachPseudoLegalMove<false>(color, [&](const PackedMove& m)
+    {
+        if (!found && leavesKingSafe(color, m))
+        {
+            found = true;
+        }
+    });
+    return found;
+}
+
+// Check one move against the legal move list
+bool BitboardBoard::isLegalMove(Color color, const Move& move) const
+{
+    PackedMove wanted = PackedMove::fromMove(move);
+    MoveList moves;
+    generateLegalMoves(color, moves);
+    for (const PackedMove& m : moves)
+    {
+        // A promotion without a piece named is taken as a queen
+        if (m.sameSquares(wanted) &&
+            (!m.isPromotion() || m.promotionType() == (wanted.isPromotion() ? wanted.promotionType() : PieceType::QUEEN)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every piece of either color attacking the square, given an occupancy
+Bitboard BitboardBoard::attackersTo(int square, Bitboard occupancyMask) const
+{
+    const Bitboard* white = pieces[0];
+    const Bitboard* black = pieces[1];
+    Bitboard rooks = white[typeIndex(PieceType::ROOK)] | black[typeIndex(PieceType::ROOK)]
+                   | white[typeIndex(PieceType::QUEEN)] | black[typeIndex(PieceType::QUEEN)];
+    Bitboard bishops = white[typeIndex(PieceType::BISHOP)] | black[typeIndex(PieceType::BISHOP)]
+                     | white[typeIndex(PieceType::QUEEN)] | black[typeIndex(PieceType::QUEEN)];
+
+    return (Attacks::pawn(Color::BLACK, square) & white[typeIndex(PieceType::PAWN)])
+         | (Attacks::pawn(Color::WHITE, square) & black[typeIndex(PieceType::PAWN)])
+         | (Attacks::knight(square) & (white[typeIndex(PieceType::KNIGHT)] | black[typeIndex(PieceType::KNIGHT)]))
+         | (Attacks::king(square) & (white[typeIndex(PieceType::KING)] | black[typeIndex(PieceType::KING)]))
+         | (Attacks::rook(square, occupancyMask) & rooks)
+         | (Attacks::bishop(square, occupancyMask) & bishops);
+}
+
+// Piece values used by the exchange evaluator, by typeIndex
+// (pawn, rook, knight, bishop, queen, king)
+static const int SEE_VALUE[6] = { 100, 500, 320, 330, 900, 20000 };
+
+// Cheapest first: pawn, knight, bishop, rook, queen, king
+static const int SEE_ORDER[6] = { 0, 2, 3, 1, 4, 5 };
+
+// Static exchange evaluation: the material balance, for the side making
+// the capture, of the whole sequence of captures on the target square when
+// both sides always recapture with their cheapest piece and may stop when
+// continuing would lose. Pieces uncovered behind a capturer (x-rays) join
+// in, since the attackers are recomputed with the updated occupancy.
+// Pins and promotions are ignored.
+int BitboardBoard::staticExchange(const PackedMove& move) const
+{
+    int from = move.from();
+    int to = move.to();
+    Piece target = pieceAt(to);
+    Piece attacker = pieceAt(from);
+
+    int gain[32];
+    int depth = 0;
+    Bitboard occ = occupied;
+    if (move.flags() == PackedMove::EN_PASSANT)
+    {
+        // The captured pawn is beside the empty target square; take it off
+        // so pieces lined up behind it can join in
+        int captured = (attacker.color == Color::WHITE) ? to - 8 : to + 8;
+        occ ^= squareBit(captured);
+        gain[0] = SEE_VALUE[typeIndex(PieceType::PAWN)];
+    }
+    else
+    {
+        gain[0] = target.isEmpty() ? 0 : SEE_VALUE[typeIndex(target.type)];
+    }
+    int attackerValue = SEE_VALUE[typeIndex(attacker.type)];
+    int side = colorIndex(opposite(attacker.color));
+    Bitboard fromBit = squareBit(from);
+
+    do
+    {
+        depth++;
+        gain[depth] = attackerValue - gain[depth - 1];  // If the piece just moved is taken
+        if (std::max(-gain[depth - 1], gain[depth]) < 0)
+        {
+            break;  // Neither side can improve by continuing
+        }
+
+        occ ^= fromBit;
+        Bitboard attackers = attackersTo(to, occ) & occ;
+
+        // Cheapest attacker of the side to recapture
+        fromBit = 0;
+        for (int i = 0; i < 6 && !fromBit; i++)
+        {
+            Bitboard candidates = attackers & pieces[side][SEE_ORDER[i]];
+            if (candidates)
+            {
+                fromBit = squareBit(lowestSquare(candidates));
+                attackerValue = SEE_VALUE[SEE_ORDER[i]];
+            }
+        }
+        side ^= 1;
+    }
+    while (fromBit && depth < 31);
+
+    while (--depth)
+    {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
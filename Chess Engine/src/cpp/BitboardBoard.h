@@ -0,0 +1,70 @@
+#ifndef BITBOARD_BOARD_H
+#define BITBOARD_BOARD_H
+
+#include "Bitboard.h"
+#include "Board.h"
+#include "MoveList.h"
+
+// Bitboard view of a position: one 64-bit mask per piece type and color.
+// Built from a Board and used for fast move generation and attack tests.
+// Generation follows the full rules: castling, en passant and promotion
+// (to any of the four pieces) included.
+class BitboardBoard
+{
+private:
+    Bitboard pieces[2][6];   // [color][piece type]
+    Bitboard occupancy[2];   // All pieces of one color
+    Bitboard occupied;       // Both colors
+    uint8_t castling;        // Board::WHITE_KINGSIDE | ... still available
+    int enPassant;           // Square a pawn just skipped over, or -1
+
+    // Calls visit(PackedMove) for every pseudo-legal move of one side
+    // (captures only if CapturesOnly)
+    template <bool CapturesOnly, typename Visit>
+    void forEachPseudoLegalMove(Color color, Visit visit) const;
+
+    // True if making the pseudo-legal move leaves color's king safe
+    bool leavesKingSafe(Color color, const PackedMove& move) const;
+
+public:
+    BitboardBoard();
+    explicit BitboardBoard(const Board& board);
+
+    // Rebuild the masks from a Board
+    void load(const Board& board);
+
+    // Board access
+    Bitboard piecesOf(Color color, PieceType type) const
+    {
+        return pieces[colorIndex(color)][typeIndex(type)];
+    }
+    Bitboard colorOccupancy(Color color) const { return occupancy[colorIndex(color)]; }
+    Bitboard allOccupancy() const { return occupied; }
+    Piece pieceAt(int square) const;
+
+    // Attack detection
+    bool isSquareAttacked(int square, Color byColor) const;
+    bool isInCheck(Color color) const;
+
+    // Pieces of both colors attacking a square, with sliders blocked by
+    // occupancyMask instead of the real occupancy
+    Bitboard attackersTo(int square, Bitboard occupancyMask) const;
+
+    // Expected material gain of a capture for the side making it, after
+    // all recaptures on that square (negative for a losing capture)
+    int staticExchange(const PackedMove& move) const;
+
+    // Move a piece, capturing whatever it takes (en passant included),
+    // promoting, and moving the rook when castling
+    void applyMove(const PackedMove& move);
+
+    // Legal move generation (moves that do not leave the mover in check).
+    // Only legal moves are added; a position Board::fromFEN accepts has at
+    // most MoveList::MAX_MOVES of them.
+    void generateLegalMoves(Color color, MoveList& moves) const;
+    void generateLegalCaptures(Color color, MoveList& moves) const;
+    bool hasLegalMove(Color color) const;
+    bool isLegalMove(Color color, const Move& move) const;
+};
+
+#endif // BITBOARD_BOARD_H
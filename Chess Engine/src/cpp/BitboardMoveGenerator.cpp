@@ -0,0 +1,44 @@
+#include "BitboardMoveGenerator.h"
+#include "BitboardBoard.h"
+
+// Build the attack tables up front so the first query is not slower
+BitboardMoveGenerator::BitboardMoveGenerator()
+{
+    Attacks::init();
+}
+
+// Check if move is legal
+bool BitboardMoveGenerator::isLegalMove(const Board& board, Color color,
+                                        const Move& move) const
+{
+    return BitboardBoard(board).isLegalMove(color, move);
+}
+
+// Check if king is in check
+bool BitboardMoveGenerator::isInCheck(const Board& board, Color color) const
+{
+    return BitboardBoard(board).isInCheck(color);
+}
+
+// Check if it's checkmate: in check and no legal moves
+bool BitboardMoveGenerator::isCheckmate(const Board& board, Color color) const
+{
+    BitboardBoard bb(board);
+    return bb.isInCheck(color) && !bb.hasLegalMove(color);
+}
+
+// Builds a list of legal moves
+std::vector<Move> BitboardMoveGenerator::getAllLegalMoves(const Board& board,
+                                                          Color color) const
+{
+    MoveList list;
+    BitboardBoard(board).generateLegalMoves(color, list);
+
+    std::vector<Move> moves;
+    moves.reserve(list.size());
+    for (const PackedMove& m : list)
+    {
+        moves.push_back(m.toMove());
+    }
+    return moves;
+}
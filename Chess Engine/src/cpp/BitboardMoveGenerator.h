@@ -0,0 +1,20 @@
+#ifndef BITBOARD_MOVE_GENERATOR_H
+#define BITBOARD_MOVE_GENERATOR_H
+
+#include "MoveGenerator.h"
+
+// Native move generator backed by BitboardBoard
+class BitboardMoveGenerator : public MoveGenerator
+{
+public:
+    BitboardMoveGenerator();
+
+    bool isLegalMove(const Board& board, Color color, const Move& move) const override;
+    bool isInCheck(const Board& board, Color color) const override;
+    bool isCheckmate(const Board& board, Color color) const override;
+    std::vector<Move> getAllLegalMoves(const Board& board, Color color) const override;
+    std::string name() const override { return "bitboard"; }
+    bool supportsSpecialMoves() const override { return true; }
+};
+
+#endif // BITBOARD_MOVE_GENERATOR_H
@@ -1,13 +1,80 @@
 #include "Board.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <sstream>
 
 // Constructor - sets up initial chess position
 Board::Board() 
+    : hashKey(0), pawnKey(0), castling(0), enPassant(-1), halfmoves(0), side(Color::WHITE), fullmoves(1)
 {
     setupInitialPosition();
 }
 
+// Pack a piece into one byte
+uint8_t Board::encode(const Piece& piece)
+{
+    if (piece.isEmpty())
+    {
+        return 0;
+    }
+    return static_cast<uint8_t>(static_cast<int>(piece.type) | (piece.color == Color::BLACK ? 8 : 0));
+}
+
+// Unpack a square byte
+Piece Board::decode(uint8_t code)
+{
+    if (code == 0)
+    {
+        return Piece();
+    }
+    return Piece(static_cast<PieceType>(code & 7), (code & 8) ? Color::BLACK : Color::WHITE);
+}
+
+// Append a square to the list for its piece. Every position the board
+// holds passes isValidPosition, which allows at most MAX_PIECES_PER_TYPE
+// of a piece, so a full list here is a caller's bug.
+void Board::listAdd(uint8_t code, int square)
+{
+    uint8_t& count = pieceCounts[code >> 3][(code & 7) - 1];
+    assert(count < MAX_PIECES_PER_TYPE);
+    pieceList[code >> 3][(code & 7) - 1][count++] = static_cast<uint8_t>(square);
+    evaluator.add(code, square);
+}
+
+// Drop a square from the list for its piece (the last entry fills the gap)
+void Board::listRemove(uint8_t code, int square)
+{
+    uint8_t* list = pieceList[code >> 3][(code & 7) - 1];
+    uint8_t& count = pieceCounts[code >> 3][(code & 7) - 1];
+    for (int i = 0; i < count; i++)
+    {
+        if (list[i] == square)
+        {
+            list[i] = list[--count];
+            evaluator.remove(code, square);
+            return;
+        }
+    }
+}
+
+// Change a listed square in place
+void Board::listMove(uint8_t code, int from, int to)
+{
+    uint8_t* list = pieceList[code >> 3][(code & 7) - 1];
+    int count = pieceCounts[code >> 3][(code & 7) - 1];
+    for (int i = 0; i < count; i++)
+    {
+        if (list[i] == from)
+        {
+            list[i] = static_cast<uint8_t>(to);
+            evaluator.move(code, from, to);
+            return;
+        }
+    }
+}
+
 // Get piece at position
 Piece Board::getPiece(int row, int col) const 
 {
@@ -15,7 +82,7 @@ Piece Board::getPiece(int row, int col) const
     {
         return Piece();  // Return empty piece if out of bounds
     }
-    return board[row][col];
+    return decode(squares[row * 8 + col]);
 }
 
 // Set piece at position
@@ -23,20 +90,93 @@ void Board::setPiece(int row, int col, const Piece& piece)
 {
     if (row >= 0 && row < 8 && col >= 0 && col < 8) 
     {
-        board[row][col] = piece;
+        int square = row * 8 + col;
+        uint8_t oldCode = squares[square];
+        uint8_t newCode = encode(piece);
+        
+        // Swap the old piece's key out of the hash and the new one in
+        hashKey ^= Zobrist::pieceKey(decode(oldCode), row, col)
+                 ^ Zobrist::pieceKey(piece, row, col);
+        if ((oldCode & 7) == static_cast<uint8_t>(PieceType::PAWN))
+        {
+            pawnKey ^= Zobrist::pieceKey(decode(oldCode), row, col);
+        }
+        if (piece.type == PieceType::PAWN)
+        {
+            pawnKey ^= Zobrist::pieceKey(piece, row, col);
+        }
+        
+        if (oldCode != 0)
+        {
+            listRemove(oldCode, square);
+        }
+        if (newCode != 0)
+        {
+            listAdd(newCode, square);
+        }
+        squares[square] = newCode;
+    }
+}
+
+// Hash every piece and the castling / en-passant state from scratch
+uint64_t Board::computeHash() const
+{
+    uint64_t key = Zobrist::castlingKey(castling) ^ Zobrist::enPassantKey(enPassant);
+    for (int c = 0; c < 2; c++) 
+    {
+        for (int t = 0; t < 6; t++) 
+        {
+            Piece piece(static_cast<PieceType>(t + 1), c == 0 ? Color::WHITE : Color::BLACK);
+            for (int i = 0; i < pieceCounts[c][t]; i++) 
+            {
+                int square = pieceList[c][t][i];
+                key ^= Zobrist::pieceKey(piece, square / 8, square % 8);
+            }
+        }
+    }
+    return key;
+}
+
+// Hash the pawns from scratch
+uint64_t Board::computePawnHash() const
+{
+    uint64_t key = 0;
+    for (int c = 0; c < 2; c++) 
+    {
+        Piece pawn(PieceType::PAWN, c == 0 ? Color::WHITE : Color::BLACK);
+        int t = static_cast<int>(PieceType::PAWN) - 1;
+        for (int i = 0; i < pieceCounts[c][t]; i++) 
+        {
+            int square = pieceList[c][t][i];
+            key ^= Zobrist::pieceKey(pawn, square / 8, square % 8);
+        }
     }
+    return key;
 }
 
 // Clear the board
 void Board::clear() 
 {
-    for (int row = 0; row < 8; row++) 
+    for (int square = 0; square < 64; square++) 
     {
-        for (int col = 0; col < 8; col++) 
+        squares[square] = 0;
+    }
+    for (int c = 0; c < 2; c++) 
+    {
+        for (int t = 0; t < 6; t++) 
         {
-            board[row][col] = Piece();
+            pieceCounts[c][t] = 0;
         }
     }
+    evaluator.clear();
+    pawnKey = 0;
+    history.clear();
+    castling = 0;
+    enPassant = -1;
+    halfmoves = 0;
+    side = Color::WHITE;
+    fullmoves = 1;
+    hashKey = computeHash();
 }
 
 // Setup initial chess position
@@ -45,36 +185,39 @@ void Board::setupInitialPosition()
     clear();
     
     // White pieces
-    board[0][0] = Piece(PieceType::ROOK, Color::WHITE);
-    board[0][1] = Piece(PieceType::KNIGHT, Color::WHITE);
-    board[0][2] = Piece(PieceType::BISHOP, Color::WHITE);
-    board[0][3] = Piece(PieceType::QUEEN, Color::WHITE);
-    board[0][4] = Piece(PieceType::KING, Color::WHITE);
-    board[0][5] = Piece(PieceType::BISHOP, Color::WHITE);
-    board[0][6] = Piece(PieceType::KNIGHT, Color::WHITE);
-    board[0][7] = Piece(PieceType::ROOK, Color::WHITE);
+    setPiece(0, 0, Piece(PieceType::ROOK, Color::WHITE));
+    setPiece(0, 1, Piece(PieceType::KNIGHT, Color::WHITE));
+    setPiece(0, 2, Piece(PieceType::BISHOP, Color::WHITE));
+    setPiece(0, 3, Piece(PieceType::QUEEN, Color::WHITE));
+    setPiece(0, 4, Piece(PieceType::KING, Color::WHITE));
+    setPiece(0, 5, Piece(PieceType::BISHOP, Color::WHITE));
+    setPiece(0, 6, Piece(PieceType::KNIGHT, Color::WHITE));
+    setPiece(0, 7, Piece(PieceType::ROOK, Color::WHITE));
     
     // White pawns
     for (int col = 0; col < 8; col++) 
     {
-        board[1][col] = Piece(PieceType::PAWN, Color::WHITE);
+        setPiece(1, col, Piece(PieceType::PAWN, Color::WHITE));
     }
     
     // Black pawns
     for (int col = 0; col < 8; col++) 
     {
-        board[6][col] = Piece(PieceType::PAWN, Color::BLACK);
+        setPiece(6, col, Piece(PieceType::PAWN, Color::BLACK));
     }
     
     // Black pieces
-    board[7][0] = Piece(PieceType::ROOK, Color::BLACK);
-    board[7][1] = Piece(PieceType::KNIGHT, Color::BLACK);
-    board[7][2] = Piece(PieceType::BISHOP, Color::BLACK);
-    board[7][3] = Piece(PieceType::QUEEN, Color::BLACK);
-    board[7][4] = Piece(PieceType::KING, Color::BLACK);
-    board[7][5] = Piece(PieceType::BISHOP, Color::BLACK);
-    board[7][6] = Piece(PieceType::KNIGHT, Color::BLACK);
-    board[7][7] = Piece(PieceType::ROOK, Color::BLACK);
+    setPiece(7, 0, Piece(PieceType::ROOK, Color::BLACK));
+    setPiece(7, 1, Piece(PieceType::KNIGHT, Color::BLACK));
+    setPiece(7, 2, Piece(PieceType::BISHOP, Color::BLACK));
+    setPiece(7, 3, Piece(PieceType::QUEEN, Color::BLACK));
+    setPiece(7, 4, Piece(PieceType::KING, Color::BLACK));
+    setPiece(7, 5, Piece(PieceType::BISHOP, Color::BLACK));
+    setPiece(7, 6, Piece(PieceType::KNIGHT, Color::BLACK));
+    setPiece(7, 7, Piece(PieceType::ROOK, Color::BLACK));
+    
+    castling = ALL_CASTLING;
+    hashKey = computeHash();
 }
 
 // Convert piece to Unicode character for display
@@ -120,7 +263,7 @@ void Board::display() const
         
         for (int col = 0; col < 8; col++) 
         {
-            Piece piece = board[row][col];
+            Piece piece = decode(squares[row * 8 + col]);
             
             // Alternate square colors with shading
             bool isLightSquare = (row + col) % 2 == 0;
@@ -217,6 +360,26 @@ std::string Board::pieceTypeToString(PieceType type)
     }
 }
 
+// Converts a Move into a coordinate string like "e2e4" (or "e7e8q" for
+// a promotion)
+std::string Board::moveToString(const Move& move)
+{
+    std::string s;
+    s += static_cast<char>('a' + move.fromCol);
+    s += static_cast<char>('1' + move.fromRow);
+    s += static_cast<char>('a' + move.toCol);
+    s += static_cast<char>('1' + move.toRow);
+    switch (move.promotion)
+    {
+        case PieceType::KNIGHT: s += 'n'; break;
+        case PieceType::BISHOP: s += 'b'; break;
+        case PieceType::ROOK:   s += 'r'; break;
+        case PieceType::QUEEN:  s += 'q'; break;
+        default: break;
+    }
+    return s;
+}
+
 // Convert board to Prolog format
 // Returns: "[piece(rook,white,1,1), piece(knight,white,1,2), ...]"
 std::string Board::toPrologFormat() const 
@@ -226,15 +389,15 @@ std::string Board::toPrologFormat() const
     
     bool first = true;
     
-    // Iterate through board and build Prolog list
-    for (int row = 0; row < 8; row++) 
+    // Walk the piece lists so empty squares are never visited
+    for (int c = 0; c < 2; c++) 
     {
-        for (int col = 0; col < 8; col++) 
+        for (int t = 0; t < 6; t++) 
         {
-            Piece piece = board[row][col];
-            
-            if (!piece.isEmpty()) 
+            for (int i = 0; i < pieceCounts[c][t]; i++) 
             {
+                int square = pieceList[c][t][i];
+                
                 if (!first) 
                 {
                     oss << ", ";
@@ -242,10 +405,10 @@ std::string Board::toPrologFormat() const
                 
                 // Prolog uses 1-indexed positions (1-8, not 0-7)
                 oss << "piece(" 
-                    << pieceTypeToString(piece.type) << ", "
-                    << colorToString(piece.color) << ", "
-                    << (row + 1) << ", "
-                    << (col + 1) << ")";
+                    << pieceTypeToString(static_cast<PieceType>(t + 1)) << ", "
+                    << (c == 0 ? "white" : "black") << ", "
+                    << (square / 8 + 1) << ", "
+                    << (square % 8 + 1) << ")";
                 
                 first = false;
             }
@@ -256,15 +419,593 @@ std::string Board::toPrologFormat() const
     return oss.str();
 }
 
+// Convert board to Scheme format
+// Returns 64 characters from a8 to h1, rank by rank: "rnbqkbnrpppppppp....."
+std::string Board::toSchemeString() const
+{
+    std::string result;
+    result.reserve(64);
+    
+    for (int row = 7; row >= 0; row--) 
+    {
+        for (int col = 0; col < 8; col++) 
+        {
+            result += pieceToChar(decode(squares[row * 8 + col]));
+        }
+    }
+    
+    return result;
+}
+
+// Convert board to the compact bridge format
+// Returns 64 characters from a1 to h8: "RNBQKBNRPPPPPPPP....."
+std::string Board::toCompactString() const
+{
+    std::string result(64, '.');
+    for (int square = 0; square < 64; square++)
+    {
+        if (squares[square] != 0)
+        {
+            result[square] = pieceToChar(decode(squares[square]));
+        }
+    }
+    return result;
+}
+
+// Piece letter (FEN case: uppercase white) -> Piece; empty piece if unknown
+static Piece pieceFromChar(char c)
+{
+    Color color = (c >= 'a') ? Color::BLACK : Color::WHITE;
+    switch (c | 0x20)
+    {
+        case 'p': return Piece(PieceType::PAWN, color);
+        case 'r': return Piece(PieceType::ROOK, color);
+        case 'n': return Piece(PieceType::KNIGHT, color);
+        case 'b': return Piece(PieceType::BISHOP, color);
+        case 'q': return Piece(PieceType::QUEEN, color);
+        case 'k': return Piece(PieceType::KING, color);
+        default: return Piece();
+    }
+}
+
+// Reads an unsigned number at pos; false if there are no digits
+static bool readNumber(std::string_view text, std::size_t& pos, int& value)
+{
+    std::size_t start = pos;
+    value = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9' && pos - start < 9)
+    {
+        value = value * 10 + (text[pos] - '0');
+        pos++;
+    }
+    return pos > start;
+}
+
+// True if a piece of color by attacks square (row * 8 + col)
+bool Board::isSquareAttacked(int square, Color by) const
+{
+    int row = square / 8;
+    int col = square % 8;
+    auto holds = [&](int r, int c, PieceType type)
+    {
+        Piece p = getPiece(r, c);
+        return p.type == type && p.color == by;
+    };
+
+    int pawnRow = (by == Color::WHITE) ? row - 1 : row + 1;
+    if (holds(pawnRow, col - 1, PieceType::PAWN) || holds(pawnRow, col + 1, PieceType::PAWN))
+    {
+        return true;
+    }
+    static const int KNIGHT_STEPS[8][2] = { {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+    static const int KING_STEPS[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    for (int i = 0; i < 8; i++)
+    {
+        if (holds(row + KNIGHT_STEPS[i][0], col + KNIGHT_STEPS[i][1], PieceType::KNIGHT) ||
+            holds(row + KING_STEPS[i][0], col + KING_STEPS[i][1], PieceType::KING))
+        {
+            return true;
+        }
+    }
+
+    // Sliders: the first piece along each line (the first four steps are
+    // straight, the rest diagonal)
+    for (int i = 0; i < 8; i++)
+    {
+        PieceType slider = (i < 4) ? PieceType::ROOK : PieceType::BISHOP;
+        int r = row + KING_STEPS[i][0];
+        int c = col + KING_STEPS[i][1];
+        while (r >= 0 && r < 8 && c >= 0 && c < 8)
+        {
+            Piece p = getPiece(r, c);
+            if (!p.isEmpty())
+            {
+                if (p.color == by && (p.type == slider || p.type == PieceType::QUEEN))
+                {
+                    return true;
+                }
+                break;
+            }
+            r += KING_STEPS[i][0];
+            c += KING_STEPS[i][1];
+        }
+    }
+    return false;
+}
+
+// The material and check rules a position must meet before the board
+// takes it: one king each, at most 16 men and 8 pawns a side, no more
+// promoted pieces than missing pawns, no pawn on the first or last rank,
+// and the side that just moved not left in check. Together they keep
+// every piece list within MAX_PIECES_PER_TYPE and every move list within
+// MoveList::MAX_MOVES.
+bool Board::isValidPosition() const
+{
+    for (int c = 0; c < 2; c++)
+    {
+        auto count = [&](PieceType type) { return static_cast<int>(pieceCounts[c][static_cast<int>(type) - 1]); };
+        int pawns = count(PieceType::PAWN);
+        int promoted = std::max(0, count(PieceType::QUEEN) - 1)
+                     + std::max(0, count(PieceType::ROOK) - 2)
+                     + std::max(0, count(PieceType::BISHOP) - 2)
+                     + std::max(0, count(PieceType::KNIGHT) - 2);
+        int men = pawns + count(PieceType::KNIGHT) + count(PieceType::BISHOP)
+                + count(PieceType::ROOK) + count(PieceType::QUEEN) + count(PieceType::KING);
+        if (count(PieceType::KING) != 1 || men > 16 || pawns > 8 || promoted > 8 - pawns)
+        {
+            return false;
+        }
+    }
+    for (int col = 0; col < 8; col++)
+    {
+        if (getPiece(0, col).type == PieceType::PAWN || getPiece(7, col).type == PieceType::PAWN)
+        {
+            return false;
+        }
+    }
+    Color waiting = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    int king = pieceSquares(waiting, PieceType::KING)[0];
+    return !isSquareAttacked(king, side);
+}
+
+// Load a position from FEN, one pass over the text with no allocation
+bool Board::fromFEN(std::string_view fen)
+{
+    clear();
+    std::size_t pos = 0;
+    auto skipSpaces = [&]()
+    {
+        while (pos < fen.size() && (fen[pos] == ' ' || fen[pos] == '\t'))
+        {
+            pos++;
+        }
+    };
+    
+    // 1. Piece placement, rank 8 first
+    skipSpaces();
+    int row = 7;
+    int col = 0;
+    for (; pos < fen.size() && fen[pos] != ' '; pos++)
+    {
+        char c = fen[pos];
+        if (c == '/')
+        {
+            if (col != 8 || row == 0)
+            {
+                clear();
+                return false;
+            }
+            row--;
+            col = 0;
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            col += c - '0';
+        }
+        else
+        {
+            Piece piece = pieceFromChar(c);
+            if (piece.isEmpty() || col > 7)
+            {
+                clear();
+                return false;
+            }
+            // Stop before a piece list would overflow; isValidPosition
+            // rejects every such position anyway
+            uint8_t code = encode(piece);
+            if (pieceCounts[code >> 3][(code & 7) - 1] >= MAX_PIECES_PER_TYPE)
+            {
+                clear();
+                return false;
+            }
+            setPiece(row, col, piece);
+            col++;
+        }
+        if (col > 8)
+        {
+            clear();
+            return false;
+        }
+    }
+    if (row != 0 || col != 8)
+    {
+        clear();
+        return false;
+    }
+    
+    // 2. Side to move
+    skipSpaces();
+    if (pos < fen.size() && (fen[pos] == 'w' || fen[pos] == 'b'))
+    {
+        side = (fen[pos] == 'w') ? Color::WHITE : Color::BLACK;
+        pos++;
+    }
+    else
+    {
+        clear();
+        return false;
+    }
+    
+    // 3. Castling rights
+    skipSpaces();
+    if (pos < fen.size() && fen[pos] == '-')
+    {
+        pos++;
+    }
+    else
+    {
+        for (; pos < fen.size() && fen[pos] != ' '; pos++)
+        {
+            switch (fen[pos])
+            {
+                case 'K': castling |= WHITE_KINGSIDE;  break;
+                case 'Q': castling |= WHITE_QUEENSIDE; break;
+                case 'k': castling |= BLACK_KINGSIDE;  break;
+                case 'q': castling |= BLACK_QUEENSIDE; break;
+                default:
+                    clear();
+                    return false;
+            }
+        }
+    }
+    
+    // 4. En-passant target square
+    skipSpaces();
+    if (pos < fen.size() && fen[pos] == '-')
+    {
+        pos++;
+    }
+    else if (pos + 1 < fen.size() && fen[pos] >= 'a' && fen[pos] <= 'h' &&
+             (fen[pos + 1] == '3' || fen[pos + 1] == '6'))
+    {
+        enPassant = static_cast<int8_t>((fen[pos + 1] - '1') * 8 + (fen[pos] - 'a'));
+        pos += 2;
+    }
+    else
+    {
+        clear();
+        return false;
+    }
+    
+    // 5-6. Halfmove clock and fullmove number, both optional
+    skipSpaces();
+    int value = 0;
+    if (readNumber(fen, pos, value))
+    {
+        halfmoves = value;
+        skipSpaces();
+        if (readNumber(fen, pos, value) && value > 0)
+        {
+            fullmoves = value;
+        }
+    }
+    
+    if (!isValidPosition())
+    {
+        clear();
+        return false;
+    }
+    hashKey = computeHash();
+    return true;
+}
+
+// Write the position as FEN
+std::string Board::toFEN() const
+{
+    std::string fen;
+    fen.reserve(96);
+    
+    for (int row = 7; row >= 0; row--)
+    {
+        int empty = 0;
+        for (int col = 0; col < 8; col++)
+        {
+            uint8_t code = squares[row * 8 + col];
+            if (code == 0)
+            {
+                empty++;
+                continue;
+            }
+            if (empty > 0)
+            {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            fen += pieceToChar(decode(code));
+        }
+        if (empty > 0)
+        {
+            fen += static_cast<char>('0' + empty);
+        }
+        if (row > 0)
+        {
+            fen += '/';
+        }
+    }
+    
+    fen += (side == Color::BLACK) ? " b " : " w ";
+    
+    if (castling == 0)
+    {
+        fen += '-';
+    }
+    if (castling & WHITE_KINGSIDE)  fen += 'K';
+    if (castling & WHITE_QUEENSIDE) fen += 'Q';
+    if (castling & BLACK_KINGSIDE)  fen += 'k';
+    if (castling & BLACK_QUEENSIDE) fen += 'q';
+    
+    fen += ' ';
+    if (enPassant < 0)
+    {
+        fen += '-';
+    }
+    else
+    {
+        fen += static_cast<char>('a' + enPassant % 8);
+        fen += static_cast<char>('1' + enPassant / 8);
+    }
+    
+    fen += ' ';
+    fen += std::to_string(halfmoves);
+    fen += ' ';
+    fen += std::to_string(fullmoves);
+    return fen;
+}
+
+// Castling rights kept when a move touches each square: moving from or
+// capturing on a king or rook home square loses the rights tied to it
+static const uint8_t CASTLING_KEPT[64] =
+{
+    13, 15, 15, 15, 12, 15, 15, 14,   // a1 clears white queenside, e1 both, h1 kingside
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     7, 15, 15, 15,  3, 15, 15, 11    // a8, e8, h8 the same for black
+};
+
 // Execute a move on the board
 void Board::executeMove(const Move& move) 
 {
-    // Get the piece at the starting position
-    Piece piece = getPiece(move.fromRow, move.fromCol);
+    makeMove(move);
+}
+
+// Piece a pawn promotes to: the one asked for, or a queen
+static PieceType promotionPiece(PieceType wanted)
+{
+    switch (wanted)
+    {
+        case PieceType::KNIGHT:
+        case PieceType::BISHOP:
+        case PieceType::ROOK:
+            return wanted;
+        default:
+            return PieceType::QUEEN;
+    }
+}
+
+// Move a castling rook between its home square and its square beside the
+// king; kingTo is the king's destination (c or g file)
+static void castlingRookSquares(int kingTo, int& rookHome, int& rookTo)
+{
+    bool kingside = (kingTo & 7) == 6;
+    rookHome = kingside ? kingTo + 1 : kingTo - 2;
+    rookTo = kingside ? kingTo - 1 : kingTo + 1;
+}
+
+// Make a move, updating the pieces, castling rights, en-passant square,
+// halfmove clock, hashes and repetition history
+UndoInfo Board::makeMove(const Move& move)
+{
+    int from = move.fromRow * 8 + move.fromCol;
+    int to = move.toRow * 8 + move.toCol;
+    uint8_t code = squares[from];
+    Piece piece = decode(code);
+    bool pawnMove = (piece.type == PieceType::PAWN);
+    
+    // En passant takes the pawn beside the origin, on the destination file
+    int captureSquare = to;
+    if (pawnMove && to == enPassant && move.fromCol != move.toCol)
+    {
+        captureSquare = move.fromRow * 8 + move.toCol;
+    }
+    uint8_t capturedCode = squares[captureSquare];
+    
+    UndoInfo undo;
+    undo.moved = piece;
+    undo.captured = decode(capturedCode);
+    undo.castlingRights = castling;
+    undo.enPassantSquare = enPassant;
+    undo.halfmoveClock = halfmoves;
+    undo.hashKey = hashKey;
+    undo.pawnHashKey = pawnKey;
+    history.push_back(hashKey);
     
-    // Move it to the destination
-    setPiece(move.toRow, move.toCol, piece);
+    // Take the captured piece off
+    if (capturedCode != 0)
+    {
+        hashKey ^= Zobrist::pieceKey(undo.captured, captureSquare / 8, captureSquare % 8);
+        if (undo.captured.type == PieceType::PAWN)
+        {
+            pawnKey ^= Zobrist::pieceKey(undo.captured, captureSquare / 8, captureSquare % 8);
+        }
+        listRemove(capturedCode, captureSquare);
+        squares[captureSquare] = 0;
+    }
+    
+    // Move the piece; a pawn reaching the last rank is replaced
+    Piece placed = piece;
+    if (pawnMove && (move.toRow == 0 || move.toRow == 7))
+    {
+        placed = Piece(promotionPiece(move.promotion), piece.color);
+    }
+    uint8_t placedCode = encode(placed);
+    hashKey ^= Zobrist::pieceKey(piece, move.fromRow, move.fromCol)
+             ^ Zobrist::pieceKey(placed, move.toRow, move.toCol);
+    if (pawnMove)
+    {
+        pawnKey ^= Zobrist::pieceKey(piece, move.fromRow, move.fromCol)
+                 ^ Zobrist::pieceKey(placed.type == PieceType::PAWN ? placed : Piece(), move.toRow, move.toCol);
+    }
+    if (placedCode == code)
+    {
+        listMove(code, from, to);
+    }
+    else
+    {
+        listRemove(code, from);
+        listAdd(placedCode, to);
+    }
+    squares[to] = placedCode;
+    squares[from] = 0;
+    
+    // Castling: the king moved two files, so the rook jumps over it
+    if (piece.type == PieceType::KING && (move.toCol - move.fromCol == 2 || move.fromCol - move.toCol == 2))
+    {
+        int rookHome, rookTo;
+        castlingRookSquares(to, rookHome, rookTo);
+        uint8_t rookCode = squares[rookHome];
+        Piece rook = decode(rookCode);
+        hashKey ^= Zobrist::pieceKey(rook, rookHome / 8, rookHome % 8)
+                 ^ Zobrist::pieceKey(rook, rookTo / 8, rookTo % 8);
+        listMove(rookCode, rookHome, rookTo);
+        squares[rookTo] = rookCode;
+        squares[rookHome] = 0;
+    }
+    
+    // The fifty-move count restarts on captures and pawn moves
+    halfmoves = (pawnMove || capturedCode != 0) ? 0 : halfmoves + 1;
+    
+    uint8_t newCastling = castling & CASTLING_KEPT[from] & CASTLING_KEPT[to];
+    hashKey ^= Zobrist::castlingKey(castling) ^ Zobrist::castlingKey(newCastling);
+    castling = newCastling;
+    
+    // A double pawn push leaves the skipped square open to en passant
+    int newEnPassant = -1;
+    if (pawnMove && (move.toRow - move.fromRow == 2 || move.fromRow - move.toRow == 2))
+    {
+        newEnPassant = (from + to) / 2;
+    }
+    hashKey ^= Zobrist::enPassantKey(enPassant) ^ Zobrist::enPassantKey(newEnPassant);
+    enPassant = static_cast<int8_t>(newEnPassant);
     
-    // Clear the starting position
-    setPiece(move.fromRow, move.fromCol, Piece());
+    if (side == Color::BLACK)
+    {
+        fullmoves++;
+    }
+    side = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    
+    return undo;
+}
+
+// Take back the last move made with makeMove
+void Board::unmakeMove(const Move& move, const UndoInfo& undo)
+{
+    int from = move.fromRow * 8 + move.fromCol;
+    int to = move.toRow * 8 + move.toCol;
+    uint8_t code = encode(undo.moved);
+    uint8_t placedCode = squares[to];
+    
+    // Write the squares directly: the saved hashes already cover them.
+    // The rook goes home first, then the piece (or the pawn it promoted from).
+    if (undo.moved.type == PieceType::KING && (move.toCol - move.fromCol == 2 || move.fromCol - move.toCol == 2))
+    {
+        int rookHome, rookTo;
+        castlingRookSquares(to, rookHome, rookTo);
+        uint8_t rookCode = squares[rookTo];
+        listMove(rookCode, rookTo, rookHome);
+        squares[rookHome] = rookCode;
+        squares[rookTo] = 0;
+    }
+    if (placedCode == code)
+    {
+        listMove(code, to, from);
+    }
+    else
+    {
+        listRemove(placedCode, to);
+        listAdd(code, from);
+    }
+    squares[from] = code;
+    squares[to] = 0;
+    
+    uint8_t capturedCode = encode(undo.captured);
+    if (capturedCode != 0)
+    {
+        bool enPassantCapture = undo.moved.type == PieceType::PAWN && to == undo.enPassantSquare;
+        int captureSquare = enPassantCapture ? move.fromRow * 8 + move.toCol : to;
+        listAdd(capturedCode, captureSquare);
+        squares[captureSquare] = capturedCode;
+    }
+    
+    castling = undo.castlingRights;
+    enPassant = undo.enPassantSquare;
+    halfmoves = undo.halfmoveClock;
+    hashKey = undo.hashKey;
+    pawnKey = undo.pawnHashKey;
+    history.pop_back();
+    
+    side = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    if (side == Color::BLACK)
+    {
+        fullmoves--;
+    }
+}
+
+// Earlier occurrences of the current position. Only every second entry can
+// match (the same side must be to move), and the search stops at the last
+// capture or pawn move.
+int Board::repetitionCount() const
+{
+    int count = 0;
+    int size = static_cast<int>(history.size());
+    int oldest = size - halfmoves;
+    for (int i = size - 4; i >= 0 && i >= oldest; i -= 2)
+    {
+        if (history[i] == hashKey)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Neither side can possibly mate: bare kings, or king and one minor piece
+bool Board::isInsufficientMaterial() const
+{
+    int minors = 0;
+    for (int c = 0; c < 2; c++)
+    {
+        if (pieceCounts[c][static_cast<int>(PieceType::PAWN) - 1] > 0 ||
+            pieceCounts[c][static_cast<int>(PieceType::ROOK) - 1] > 0 ||
+            pieceCounts[c][static_cast<int>(PieceType::QUEEN) - 1] > 0)
+        {
+            return false;
+        }
+        minors += pieceCounts[c][static_cast<int>(PieceType::KNIGHT) - 1]
+                + pieceCounts[c][static_cast<int>(PieceType::BISHOP) - 1];
+    }
+    return minors <= 1;
 }
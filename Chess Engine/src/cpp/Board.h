@@ -1,7 +1,10 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include "Evaluator.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -36,31 +39,125 @@ struct Piece
     bool isEmpty() const { return type == PieceType::EMPTY; }
 };
 
-// Represents a move from one square to another
+// Represents a move from one square to another. Castling is the king's
+// two-square move; en passant is the pawn's diagonal move to the empty
+// en-passant square.
 struct Move 
 {
     int fromRow, fromCol;
     int toRow, toCol;
+    PieceType promotion;  // Piece a pawn reaching the last rank becomes (EMPTY = queen)
     
-    Move(int fr, int fc, int tr, int tc) 
-        : fromRow(fr), fromCol(fc), toRow(tr), toCol(tc) {}
+    Move(int fr, int fc, int tr, int tc, PieceType promo = PieceType::EMPTY) 
+        : fromRow(fr), fromCol(fc), toRow(tr), toCol(tc), promotion(promo) {}
+};
+
+// Everything makeMove overwrites, so unmakeMove can put it back
+struct UndoInfo
+{
+    Piece moved;              // Piece that left the origin square (a pawn for promotions)
+    Piece captured;           // Piece taken, on the destination or (en passant) beside it
+    uint8_t castlingRights;
+    int8_t enPassantSquare;
+    int halfmoveClock;
+    uint64_t hashKey;
+    uint64_t pawnHashKey;
 };
 
 // Da Board Class
+//
+// Squares are stored one byte each (mailbox-64, index row * 8 + col), and
+// every piece is also listed by color and type so code that only cares
+// about the pieces on the board can skip the empty squares.
 class Board 
 {
+public:
+    // Most of one piece a valid position can hold: two rooks, knights or
+    // bishops plus eight promoted pawns (see fromFEN)
+    static const int MAX_PIECES_PER_TYPE = 10;
+
 private:
-    Piece board[8][8];
+    uint8_t squares[64];     // Packed piece code per square, 0 = empty
+    uint8_t pieceList[2][6][MAX_PIECES_PER_TYPE];  // [color][type] -> squares
+    uint8_t pieceCounts[2][6];
+    uint64_t hashKey;        // Zobrist key, kept up to date by setPiece and makeMove
+    uint64_t pawnKey;        // Zobrist key of the pawns alone
+    Evaluator evaluator;     // Running evaluation, kept up to date with the piece lists
+    uint8_t castling;        // Castling rights bits still available
+    int8_t enPassant;        // Square a pawn just skipped over, or -1
+    int halfmoves;           // Plies since the last capture or pawn move
+    Color side;              // Side to move
+    int fullmoves;           // Starts at 1, incremented after Black moves
+    std::vector<uint64_t> history;  // hash() before each move made, oldest first
     
     // Helper to get Unicode piece symbol
     std::string getPieceUnicode(const Piece& piece) const;
     
+    // Packed piece codes: type in the low 3 bits, 8 added for black
+    static uint8_t encode(const Piece& piece);
+    static Piece decode(uint8_t code);
+    
+    // Piece list and evaluation upkeep (squares[] and the hash are handled
+    // by the caller)
+    void listAdd(uint8_t code, int square);
+    void listRemove(uint8_t code, int square);
+    void listMove(uint8_t code, int from, int to);
+    
+    // Position checks for fromFEN
+    bool isSquareAttacked(int square, Color by) const;
+    bool isValidPosition() const;
+    
 public:
+    // Castling rights bits
+    static const uint8_t WHITE_KINGSIDE  = 1;
+    static const uint8_t WHITE_QUEENSIDE = 2;
+    static const uint8_t BLACK_KINGSIDE  = 4;
+    static const uint8_t BLACK_QUEENSIDE = 8;
+    static const uint8_t ALL_CASTLING    = 15;
+
     Board();  // Constructor
     
     // Board access
     Piece getPiece(int row, int col) const;
-    void setPiece(int row, int col, const Piece& piece);
+    void setPiece(int row, int col, const Piece& piece);  // Caller stays within fromFEN's limits
+    
+    // Squares (row * 8 + col) holding pieces of one color and type, in no
+    // particular order
+    int pieceCount(Color color, PieceType type) const
+    {
+        return pieceCounts[color == Color::BLACK][static_cast<int>(type) - 1];
+    }
+    const uint8_t* pieceSquares(Color color, PieceType type) const
+    {
+        return pieceList[color == Color::BLACK][static_cast<int>(type) - 1];
+    }
+    
+    // Position state besides the pieces
+    uint8_t castlingRights() const { return castling; }
+    int enPassantSquare() const { return enPassant; }  // row * 8 + col, or -1
+    int halfmoveClock() const { return halfmoves; }
+    Color sideToMove() const { return side; }
+    int fullmoveNumber() const { return fullmoves; }
+    void setSideToMove(Color color) { side = color; }
+    
+    // Zobrist key of the pieces, castling rights and en-passant square
+    // (side to move not included)
+    uint64_t hash() const { return hashKey; }
+    uint64_t computeHash() const;  // Full recomputation, for checking
+    
+    // Draw rules. repetitionCount is how many times the current position
+    // occurred before; it only looks back to the last capture or pawn move,
+    // since no earlier position can recur, so it stays cheap inside search.
+    int repetitionCount() const;
+    bool isFiftyMoveDraw() const { return halfmoves >= 100; }
+    bool isInsufficientMaterial() const;  // Bare kings, or king and one minor piece
+    
+    // Zobrist key of the pawns only, for the pawn structure cache
+    uint64_t pawnHash() const { return pawnKey; }
+    uint64_t computePawnHash() const;
+    
+    // Incrementally maintained material and piece-square evaluation
+    const Evaluator& evaluation() const { return evaluator; }
     
     // Display
     void display() const;
@@ -68,9 +165,35 @@ public:
     // Convert to Prolog format
     std::string toPrologFormat() const;
     
+    // Convert to the 64-character string ai.rkt expects (a8 first, '.' = empty)
+    std::string toSchemeString() const;
+    
+    // The same 64 characters in square order (a1 first), as wire_board/2 reads them
+    std::string toCompactString() const;
+    
+    // Forsyth-Edwards Notation with the full state (side to move, castling,
+    // en passant, both clocks). fromFEN does not allocate; the clocks may be
+    // left out, and anything after them (EPD operations) is ignored. It
+    // returns false and leaves the board empty on a malformed string and on
+    // a position no game can reach by its material: a king missing or
+    // doubled, more than 16 men or 8 pawns a side, more promoted pieces
+    // than missing pawns, a pawn on the first or last rank, or the side not
+    // to move in check. Positions that pass stay within the piece lists and
+    // MoveList::MAX_MOVES.
+    bool fromFEN(std::string_view fen);
+    std::string toFEN() const;
+    
     // Execute a move
     void executeMove(const Move& move);
     
+    // Make a move and return what is needed to take it back. Moves must be
+    // unmade in the reverse order they were made, so a search can walk the
+    // whole tree on one Board. Both hand the move to the other side.
+    // Castling moves the rook too, en passant removes the pawn passed by,
+    // and a pawn reaching the last rank is promoted. The move must be legal.
+    UndoInfo makeMove(const Move& move);
+    void unmakeMove(const Move& move, const UndoInfo& undo);
+    
     // Setup
     void setupInitialPosition();
     void clear();  // Empty the board
@@ -79,6 +202,7 @@ public:
     static char pieceToChar(const Piece& piece);
     static std::string colorToString(Color color);
     static std::string pieceTypeToString(PieceType type);
+    static std::string moveToString(const Move& move);  // "e2e4", "e7e8q"
 };
 
 #endif // BOARD_H
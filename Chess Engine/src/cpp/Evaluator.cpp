@@ -0,0 +1,104 @@
+#include "Evaluator.h"
+#include "Board.h"
+
+// How central a square is: 4 on d4, falling off with Manhattan distance
+static constexpr int centerScore(int row, int col)
+{
+    int dist = (row > 3 ? row - 3 : 3 - row) + (col > 3 ? col - 3 : 3 - col);
+    return dist < 4 ? 4 - dist : 0;
+}
+
+// Middlegame value of a White piece: material plus centralisation (the
+// terms of evaluate-board in ai.rkt), with the king kept out of the centre
+static constexpr int middlegameValue(PieceType type, int row, int col)
+{
+    int c = centerScore(row, col);
+    switch (type)
+    {
+        case PieceType::PAWN:   return 100 + c * 2;
+        case PieceType::KNIGHT: return 320 + c * 10;
+        case PieceType::BISHOP: return 330 + c * 6;
+        case PieceType::ROOK:   return 500 + c * 2;
+        case PieceType::QUEEN:  return 900 + c * 2;
+        case PieceType::KING:   return 20000 + 2 - c;
+        default: return 0;
+    }
+}
+
+// Endgame value of a White piece: pawns gain as they advance and the king
+// belongs in the centre
+static constexpr int endgameValue(PieceType type, int row, int col)
+{
+    int c = centerScore(row, col);
+    switch (type)
+    {
+        case PieceType::PAWN:   return 110 + (row - 1) * 10;
+        case PieceType::KNIGHT: return 300 + c * 10;
+        case PieceType::BISHOP: return 320 + c * 6;
+        case PieceType::ROOK:   return 520 + c * 2;
+        case PieceType::QUEEN:  return 920 + c * 2;
+        case PieceType::KING:   return 20000 + c * 8;
+        default: return 0;
+    }
+}
+
+// Contribution to the game phase: minor pieces 1, rooks 2, queens 4
+static constexpr int phaseWeight(PieceType type)
+{
+    switch (type)
+    {
+        case PieceType::KNIGHT: return 1;
+        case PieceType::BISHOP: return 1;
+        case PieceType::ROOK:   return 2;
+        case PieceType::QUEEN:  return 4;
+        default: return 0;
+    }
+}
+
+// Fill the tables for every code. A Black piece on (row, col) is worth
+// minus a White one on the mirrored square (7 - row, col).
+static constexpr Evaluator::Tables buildTables()
+{
+    Evaluator::Tables t = {};
+    for (int type = 1; type <= 6; type++)
+    {
+        PieceType pieceType = static_cast<PieceType>(type);
+        int black = type | 8;
+        t.phase[type] = phaseWeight(pieceType);
+        t.phase[black] = phaseWeight(pieceType);
+        for (int square = 0; square < 64; square++)
+        {
+            int row = square / 8;
+            int col = square % 8;
+            t.mg[type][square] = middlegameValue(pieceType, row, col);
+            t.eg[type][square] = endgameValue(pieceType, row, col);
+            t.mg[black][square] = -middlegameValue(pieceType, 7 - row, col);
+            t.eg[black][square] = -endgameValue(pieceType, 7 - row, col);
+        }
+    }
+    return t;
+}
+
+// Built at compile time, so Boards created during static initialisation
+// already see the values
+const Evaluator::Tables Evaluator::tables = buildTables();
+
+// Sum every piece from scratch
+int Evaluator::evaluate(const Board& board)
+{
+    Evaluator sum;
+    for (int c = 0; c < 2; c++)
+    {
+        Color color = (c == 0) ? Color::WHITE : Color::BLACK;
+        for (int t = 1; t <= 6; t++)
+        {
+            uint8_t code = static_cast<uint8_t>(t | (c == 0 ? 0 : 8));
+            const uint8_t* list = board.pieceSquares(color, static_cast<PieceType>(t));
+            for (int i = 0; i < board.pieceCount(color, static_cast<PieceType>(t)); i++)
+            {
+                sum.add(code, list[i]);
+            }
+        }
+    }
+    return sum.score();
+}
@@ -0,0 +1,79 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <cstdint>
+
+class Board;
+
+// Material and piece-square evaluation kept as running totals.
+//
+// Every (piece, square) pair has a middlegame and an endgame value, and
+// the position's score is the sum over its pieces, blended by game phase
+// (how much non-pawn material is left). Board calls add/remove/move
+// whenever a piece appears, disappears or moves, so reading the score at
+// a leaf is O(1) instead of a walk over the board.
+//
+// Pieces are given as Board's square codes: the PieceType value in the
+// low 3 bits, plus 8 for Black.
+class Evaluator
+{
+public:
+    // Phase weight of all the starting non-pawn material
+    static const int PHASE_TOTAL = 24;
+
+    // Per-code, per-square values with Black's already negated
+    struct Tables
+    {
+        int mg[16][64];
+        int eg[16][64];
+        int phase[16];
+    };
+
+private:
+    static const Tables tables;
+
+    int mg;     // Middlegame sum, White minus Black
+    int eg;     // Endgame sum, White minus Black
+    int phase;  // Sum of phase weights of the pieces on the board
+
+public:
+    Evaluator() : mg(0), eg(0), phase(0) {}
+
+    void clear() { mg = eg = phase = 0; }
+
+    void add(uint8_t code, int square)
+    {
+        mg += tables.mg[code][square];
+        eg += tables.eg[code][square];
+        phase += tables.phase[code];
+    }
+
+    void remove(uint8_t code, int square)
+    {
+        mg -= tables.mg[code][square];
+        eg -= tables.eg[code][square];
+        phase -= tables.phase[code];
+    }
+
+    void move(uint8_t code, int from, int to)
+    {
+        mg += tables.mg[code][to] - tables.mg[code][from];
+        eg += tables.eg[code][to] - tables.eg[code][from];
+    }
+
+    // Blend a middlegame and an endgame value by the current game phase
+    int taper(int mgValue, int egValue) const
+    {
+        int p = phase < PHASE_TOTAL ? phase : PHASE_TOTAL;
+        return (mgValue * p + egValue * (PHASE_TOTAL - p)) / PHASE_TOTAL;
+    }
+
+    // Tapered score in centipawns from White's point of view
+    int score() const { return taper(mg, eg); }
+
+    // The same score computed from scratch over the board's piece lists
+    // (for checking the running totals and for benchmarks)
+    static int evaluate(const Board& board);
+};
+
+#endif // EVALUATOR_H
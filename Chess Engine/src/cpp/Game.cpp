@@ -1,13 +1,29 @@
 #include "Game.h"
+#include "Zobrist.h"
 #include <iostream>
 #include <sstream>
 #include <cctype>
+#include <chrono>
+#include <cstring>
 #include <algorithm>
 
-Game::Game(const std::string& prologPath, const std::string& schemePath) 
-    : prolog(prologPath), scheme(schemePath), currentPlayer(Color::WHITE), gameOver(false) 
+Game::Game(const std::string& prologPath, const std::string& schemePath,
+           const GameOptions& gameOptions)
+    : rules(createMoveGenerator(gameOptions.rulesBackend, prologPath)), scheme(schemePath),
+      table(gameOptions.hashMB), search(table, gameOptions.threads), options(gameOptions), currentPlayer(Color::WHITE), gameOver(false),
+      plies(0)
     {
     board.setupInitialPosition();
+    rules->newGame();
+    
+    if (!options.statsPath.empty())
+    {
+        statsFile.open(options.statsPath, std::ios::app);
+        if (!statsFile)
+        {
+            std::cerr << "Warning: cannot write stats to " << options.statsPath << "\n";
+        }
+    }
 }
 
 // Switch between white and black
@@ -41,7 +57,7 @@ Move Game::parseMove(const std::string& input) const
     // Remove spaces
     clean.erase(std::remove(clean.begin(), clean.end(), ' '), clean.end());
     
-    if (clean.length() != 4) 
+    if (clean.length() != 4 && clean.length() != 5) 
     {
         return Move(-1, -1, -1, -1);  // Invalid
     }
@@ -67,7 +83,21 @@ Move Game::parseMove(const std::string& input) const
         return Move(-1, -1, -1, -1);  // Invalid
     }
     
-    return Move(fromRow, fromCol, toRow, toCol);
+    // Optional promotion piece: e7e8q, e7e8n, ...
+    PieceType promotion = PieceType::EMPTY;
+    if (clean.length() == 5)
+    {
+        switch (tolower(clean[4]))
+        {
+            case 'q': promotion = PieceType::QUEEN;  break;
+            case 'r': promotion = PieceType::ROOK;   break;
+            case 'b': promotion = PieceType::BISHOP; break;
+            case 'n': promotion = PieceType::KNIGHT; break;
+            default: return Move(-1, -1, -1, -1);  // Invalid
+        }
+    }
+    
+    return Move(fromRow, fromCol, toRow, toCol, promotion);
 }
 
 // Check if input format is valid
@@ -76,11 +106,12 @@ bool Game::isValidInput(const std::string& input) const
     std::string clean = input;
     clean.erase(std::remove(clean.begin(), clean.end(), ' '), clean.end());
     
-    if (clean.length() != 4) return false;
+    if (clean.length() != 4 && clean.length() != 5) return false;
     
-    // Check format: letter, digit, letter, digit
+    // Check format: letter, digit, letter, digit, optional promotion letter
     return isalpha(clean[0]) && isdigit(clean[1]) &&
-           isalpha(clean[2]) && isdigit(clean[3]);
+           isalpha(clean[2]) && isdigit(clean[3]) &&
+           (clean.length() == 4 || std::strchr("qrbnQRBN", clean[4]) != nullptr);
 }
 
 // Get move from human player
@@ -121,33 +152,87 @@ Move Game::getHumanMove()
             continue;
         }
         
+        // A lookup in the legal moves already fetched for this position
+        if (!cachedStatus(currentPlayer).contains(move))
+        {
+            std::cout << "Illegal move!\n";
+            continue;
+        }
+        
         return move;
     }
 }
 
-// Converts a Move into a coordinate string like "e2e4"
-static std::string moveToString(const Move& move)
+// Lets the AI pick a move with the native search, or with ai.rkt if selected
+Move Game::getAIMove()
 {
-    char fromFile = 'a' + move.fromCol;
-    char fromRank = '1' + move.fromRow;
-    char toFile   = 'a' + move.toCol;
-    char toRank   = '1' + move.toRow;
+    std::cout << "\nAI is thinking...\n";
+
+    lastSearch = SearchResult();
+    if (options.aiBackend == AiBackend::SCHEME)
+    {
+        return getSchemeMove();
+    }
 
-    std::string s;
-    s += fromFile;
-    s += fromRank;
-    s += toFile;
-    s += toRank;
-    return s;
+    // The search generates its own moves natively; the root is limited
+    // to what the rules backend allows (Prolog has no castling or en
+    // passant), so every move it returns passes makeMove
+    SearchLimits limits = options.limits;
+    limits.searchMoves = cachedStatus(currentPlayer).legalMoves;
+
+    // The search returns the Move itself, no string round-trip needed
+    SearchResult result = search.think(board, currentPlayer, limits);
+    lastSearch = result;
+
+    // When playing on a clock, charge the AI for its thinking time
+    int spentMs = static_cast<int>(result.seconds * 1000.0);
+    if (currentPlayer == Color::WHITE && options.limits.whiteTime > 0)
+    {
+        options.limits.whiteTime += options.limits.whiteInc - spentMs;
+        if (options.limits.whiteTime < 1) options.limits.whiteTime = 1;
+    }
+    else if (currentPlayer == Color::BLACK && options.limits.blackTime > 0)
+    {
+        options.limits.blackTime += options.limits.blackInc - spentMs;
+        if (options.limits.blackTime < 1) options.limits.blackTime = 1;
+    }
+
+    if (result.nodes > 0)
+    {
+        double probes = result.ttProbes > 0 ? static_cast<double>(result.ttProbes) : 1.0;
+        double stores = result.ttStores > 0 ? static_cast<double>(result.ttStores) : 1.0;
+        std::cout << "Depth " << result.depth << ", " << result.nodes << " nodes ("
+                  << (result.nodes - result.qsearchNodes) << " main, " << result.qsearchNodes
+                  << " qsearch) in " << spentMs << " ms, "
+                  << "TT hits " << (100.0 * result.ttHits / probes) << "%, "
+                  << "overwrites " << (100.0 * result.ttOverwrites / stores) << "%, "
+                  << "hashfull " << result.hashfull << "/1000, "
+                  << "pawn hash hits " << (100.0 * result.pawnHitRate()) << "%, "
+                  << "first-move cutoffs " << (100.0 * result.firstMoveCutoffRate()) << "%\n";
+
+        // Per-thread and aggregate speed, to check how the threads scale
+        if (result.threads.size() > 1)
+        {
+            double total = 0.0;
+            for (std::size_t i = 0; i < result.threads.size(); i++)
+            {
+                const SearchThreadStats& t = result.threads[i];
+                std::cout << "  thread " << i << ": depth " << t.depth << ", " << t.nodes
+                          << " nodes, " << static_cast<uint64_t>(t.nodesPerSecond()) << " nps\n";
+                total += t.nodesPerSecond();
+            }
+            std::cout << "  total: " << static_cast<uint64_t>(total) << " nps over "
+                      << result.threads.size() << " threads\n";
+        }
+    }
+    return result.bestMove;
 }
 
-// Lets the AI pick a move using Prolog for legality and Scheme for decision-making
-Move Game::getAIMove()
+// Lets the Scheme AI pick a move using the rules backend for legality
+Move Game::getSchemeMove()
 {
-    std::cout << "\nAI is thinking...\n";
-
-    // Ask Prolog for all legal moves in the current position
-    std::vector<Move> legalMoves = prolog.getAllLegalMoves(board, currentPlayer);
+    // Legal moves in the current position, usually already cached
+    const std::vector<Move>& legalMoves = cachedStatus(currentPlayer).legalMoves;
 
     // If there are no legal moves, return an invalid move as a signal
     if (legalMoves.empty())
@@ -159,14 +244,19 @@ Move Game::getAIMove()
     std::vector<std::string> moveStrings;
     moveStrings.reserve(legalMoves.size());
     for (const auto& m : legalMoves)
-        moveStrings.push_back(moveToString(m));
+        moveStrings.push_back(Board::moveToString(m));
 
     // Prepare color and board strings to pass into Scheme
     std::string colorStr = Board::colorToString(currentPlayer);
     std::string boardStr = board.toSchemeString();
 
-    // Ask Scheme to choose one move from the list of legal moves
-    std::string chosen = scheme.chooseMove(colorStr, boardStr, moveStrings);
+    // Ask Scheme to choose one move from the list of legal moves, within
+    // --movetime if one was given
+    auto start = std::chrono::steady_clock::now();
+    std::string chosen = scheme.chooseMove(colorStr, boardStr, moveStrings, options.limits.moveTime);
+    std::cout << "Scheme AI answered in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms\n";
 
     // If Scheme fails to return a move, signal failure with an invalid move
     if (chosen.empty())
@@ -176,23 +266,96 @@ Move Game::getAIMove()
     return parseMove(chosen);
 }
 
+// Appends a "key":value pair to a JSON object under construction
+template <typename T>
+static void jsonField(std::ostringstream& out, const char* key, const T& value)
+{
+    out << (out.tellp() > 1 ? "," : "") << '"' << key << "\":" << value;
+}
+
+// Record one AI move for the end-of-game histogram and the stats file
+void Game::recordAIMove(const Move& move, double wallMs, const PhaseTimes& gameThread)
+{
+    aiLatency.add(wallMs);
+    if (!statsFile.is_open())
+    {
+        return;
+    }
+
+    // Search phases come from the search threads, bridge I/O from this one
+    PhaseTimes phases = lastSearch.phases;
+    int bridge = static_cast<int>(Phase::BRIDGE);
+    phases.nanos[bridge] = gameThread.nanos[bridge];
+    phases.calls[bridge] = gameThread.calls[bridge];
+    const SearchResult& r = lastSearch;
+
+    std::ostringstream json;
+    json << "{";
+    jsonField(json, "ply", plies);
+    jsonField(json, "side", "\"" + Board::colorToString(currentPlayer) + "\"");
+    jsonField(json, "move", "\"" + Board::moveToString(move) + "\"");
+    jsonField(json, "ai", options.aiBackend == AiBackend::SCHEME ? "\"scheme\"" : "\"native\"");
+    jsonField(json, "wall_ms", wallMs);
+    jsonField(json, "depth", r.depth);
+    jsonField(json, "score", r.score);
+    jsonField(json, "nodes", r.nodes);
+    jsonField(json, "qnodes", r.qsearchNodes);
+    jsonField(json, "nps", static_cast<uint64_t>(r.seconds > 0 ? r.nodes / r.seconds : 0));
+    jsonField(json, "tt_probes", r.ttProbes);
+    jsonField(json, "tt_hits", r.ttHits);
+    jsonField(json, "beta_cutoffs", r.betaCutoffs);
+    jsonField(json, "first_move_cutoffs", r.firstMoveCutoffs);
+    jsonField(json, "branching_factor", r.effectiveBranchingFactor());
+    jsonField(json, "search_ms", r.seconds * 1000.0);
+    jsonField(json, "phase_timing", PhaseTimes::enabled() ? "true" : "false");
+    jsonField(json, "movegen_ms", phases.milliseconds(Phase::MOVEGEN));
+    jsonField(json, "eval_ms", phases.milliseconds(Phase::EVAL));
+    jsonField(json, "bridge_ms", phases.milliseconds(Phase::BRIDGE));
+    jsonField(json, "bridge_calls", phases.calls[bridge]);
+    json << "}";
+    statsFile << json.str() << "\n";
+    statsFile.flush();
+}
+
+// Legal moves and check state for color on the current board, asking
+// the rules backend only the first time a position is seen
+const PositionStatus& Game::cachedStatus(Color color)
+{
+    uint64_t key = board.hash() ^ (color == Color::BLACK ? Zobrist::sideKey() : 0);
+    auto found = statusCache.find(key);
+    if (found == statusCache.end())
+    {
+        found = statusCache.emplace(key, rules->positionStatus(board, color)).first;
+    }
+    return found->second;
+}
+
 // Attempt to make a move
 bool Game::makeMove(const Move& move) 
 {
-    // Validate with Prolog
-    if (!prolog.isLegalMove(board, currentPlayer, move)) 
+    // Validate against the legal moves of this position
+    if (!cachedStatus(currentPlayer).contains(move)) 
     {
         std::cout << "Illegal move!\n";
         return false;
     }
     
     // Execute the move
+    uint8_t castlingBefore = board.castlingRights();
     board.executeMove(move);
     
-    // Check for check/checkmate
+    // After a capture, a pawn move or lost castling rights no earlier
+    // position can come back, so their answers are dropped
+    if (board.halfmoveClock() == 0 || board.castlingRights() != castlingBefore)
+    {
+        statusCache.clear();
+    }
+    
+    // Check for check/checkmate, and stalemate, with a single backend query
     Color opponent = (currentPlayer == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    const PositionStatus& status = cachedStatus(opponent);
     
-    if (prolog.isCheckmate(board, opponent)) 
+    if (status.checkmate) 
     {
         std::cout << "\n*** CHECKMATE! " 
                   << (currentPlayer == Color::WHITE ? "White" : "Black")
@@ -201,10 +364,33 @@ bool Game::makeMove(const Move& move)
         return true;
     }
     
-    if (prolog.isInCheck(board, opponent)) 
+    if (status.inCheck) 
     {
         std::cout << "\n*** CHECK! ***\n";
     }
+    else if (status.stalemate)
+    {
+        std::cout << "\n*** STALEMATE! Draw. ***\n";
+        gameOver = true;
+        return true;
+    }
+    
+    // Draws by rule
+    if (board.isFiftyMoveDraw())
+    {
+        std::cout << "\n*** DRAW by the fifty-move rule ***\n";
+        gameOver = true;
+    }
+    else if (board.repetitionCount() >= 2)
+    {
+        std::cout << "\n*** DRAW by threefold repetition ***\n";
+        gameOver = true;
+    }
+    else if (board.isInsufficientMaterial())
+    {
+        std::cout << "\n*** DRAW by insufficient material ***\n";
+        gameOver = true;
+    }
     
     return true;
 }
@@ -223,6 +409,8 @@ void Game::play()
     std::cout << "\n";
     std::cout << "  Commands:\n";
     std::cout << "    • Move format: e2 e4 (or e2e4)\n";
+    std::cout << "    • Castle by moving the king two squares (e1g1)\n";
+    std::cout << "    • Promote with a piece letter: e7e8q\n";
     std::cout << "    • Type 'quit' or 'exit' to end\n";
     std::cout << "\n";
     
@@ -232,8 +420,13 @@ void Game::play()
         displayStatus();
         
         Move move(-1, -1, -1, -1);
+        bool aiMove = (currentPlayer == Color::BLACK);
+        
+        // AI moves are timed from the search to the end of validation
+        auto start = std::chrono::steady_clock::now();
+        PhaseTimes phasesBefore = PhaseTimes::thisThread();
 
-        if (currentPlayer == Color::WHITE)
+        if (!aiMove)
         {
             // Human plays White
             move = getHumanMove();
@@ -246,12 +439,41 @@ void Game::play()
         
         if (gameOver) break;
         
-        if (makeMove(move)) 
+        bool made = makeMove(move);
+        if (!made && aiMove)
         {
+            // Asking again would return the same move from the same position
+            std::cout << "\n*** The AI has no move the rules allow ("
+                      << (move.fromRow < 0 ? std::string("none") : Board::moveToString(move))
+                      << "); game ended ***\n";
+            gameOver = true;
+        }
+        else if (made)
+        {
+            plies++;
+            if (aiMove)
+            {
+                double wallMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+                recordAIMove(move, wallMs, PhaseTimes::thisThread() - phasesBefore);
+            }
             switchPlayer();
         }
     }
     
+    // Latency of the AI's moves over the whole game
+    if (aiLatency.count() > 0)
+    {
+        std::cout << "\nAI move latency: " << aiLatency.summary();
+        if (statsFile.is_open())
+        {
+            statsFile << "{\"summary\":true,\"moves\":" << aiLatency.count()
+                      << ",\"p50_ms\":" << aiLatency.percentile(50)
+                      << ",\"p95_ms\":" << aiLatency.percentile(95)
+                      << ",\"p99_ms\":" << aiLatency.percentile(99) << "}\n";
+        }
+    }
+    
     board.display();
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════╗\n";
@@ -2,18 +2,63 @@
 #define GAME_H
 
 #include "Board.h"
-#include "PrologInterface.h"
+#include "MoveGenerator.h"
 #include "SchemeInterface.h"
+#include "Instrumentation.h"
+#include "ParallelSearch.h"
+#include <fstream>
+#include <memory>
 #include <string>
+#include <unordered_map>
+
+// Which engine picks the AI's moves
+enum class AiBackend
+{
+    NATIVE,  // In-process C++ alpha-beta search
+    SCHEME   // racket ai.rkt as a resident server, restarted if it crashes or
+             // times out; one process per move if it cannot be started
+};
+
+// Settings chosen on the command line
+struct GameOptions
+{
+    MoveBackend rulesBackend;
+    AiBackend aiBackend;
+    SearchLimits limits;  // Depth and/or time budget for the native AI
+    int hashMB;           // Transposition table size
+    int threads;          // Lazy SMP search threads
+    std::string statsPath;  // One JSON line per AI move is appended here, if set
+
+    GameOptions()
+        : rulesBackend(MoveBackend::BITBOARD), aiBackend(AiBackend::NATIVE), hashMB(16), threads(1)
+    {
+        limits.depth = 4;
+    }
+};
 
 class Game 
 {
 private:
     Board board;
-    PrologInterface prolog;
+    std::unique_ptr<MoveGenerator> rules;  // Legality, check and checkmate
     SchemeInterface scheme;
+    TranspositionTable table;
+    ParallelSearch search;
+    GameOptions options;
     Color currentPlayer;
     bool gameOver;
+    int plies;                     // Moves made so far, both sides
+    SearchResult lastSearch;       // Native search behind the last AI move
+    std::ofstream statsFile;       // Open if options.statsPath is set
+    LatencyHistogram aiLatency;    // Wall time of every AI move
+    
+    // Backend answers per (position hash, side to move). Each ply costs
+    // one positionStatus call: it is made when the previous move is
+    // checked for mate, and validating this ply's move is a lookup in it.
+    // Cleared on every irreversible move, so it only holds positions
+    // since the last one (at most the fifty-move window).
+    std::unordered_map<uint64_t, PositionStatus> statusCache;
+    const PositionStatus& cachedStatus(Color color);
     
     // Input parsing
     Move parseMove(const std::string& input) const;
@@ -23,8 +68,14 @@ private:
     void switchPlayer();
     void displayStatus() const;
     
+    // Record one AI move: latency histogram, and a JSON line if enabled.
+    // gameThread is the phase time spent on this thread during the move
+    // (only its bridge time is used; search phases come from lastSearch).
+    void recordAIMove(const Move& move, double wallMs, const PhaseTimes& gameThread);
+    
 public:
-    Game(const std::string& prologPath, const std::string& schemePath);
+    Game(const std::string& prologPath, const std::string& schemePath,
+         const GameOptions& gameOptions = GameOptions());
     
     // Main game loop
     void play();
@@ -35,6 +86,9 @@ public:
     // Get move from AI
     Move getAIMove();
     
+    // Get move from the Scheme AI (ai.rkt)
+    Move getSchemeMove();
+    
     // Process a move
     bool makeMove(const Move& move);
 };
@@ -0,0 +1,94 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+PhaseTimes& PhaseTimes::operator+=(const PhaseTimes& other)
+{
+    for (int i = 0; i < COUNT; i++)
+    {
+        nanos[i] += other.nanos[i];
+        calls[i] += other.calls[i];
+    }
+    return *this;
+}
+
+PhaseTimes PhaseTimes::operator-(const PhaseTimes& earlier) const
+{
+    PhaseTimes difference;
+    for (int i = 0; i < COUNT; i++)
+    {
+        difference.nanos[i] = nanos[i] - earlier.nanos[i];
+        difference.calls[i] = calls[i] - earlier.calls[i];
+    }
+    return difference;
+}
+
+// True if the phase timers were compiled in
+bool PhaseTimes::enabled()
+{
+#ifdef USE_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Nearest-rank percentile of the samples
+double LatencyHistogram::percentile(double p) const
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Count, percentiles, then one line per bucket [2^k, 2^(k+1)) ms from the
+// fastest occupied one up
+std::string LatencyHistogram::summary() const
+{
+    std::ostringstream out;
+    if (samples.empty())
+    {
+        out << "No moves timed\n";
+        return out.str();
+    }
+
+    out << samples.size() << " moves, p50 " << percentile(50) << " ms, p95 " << percentile(95)
+        << " ms, p99 " << percentile(99) << " ms, max " << percentile(100) << " ms\n";
+
+    // Bucket 0 holds everything under 1 ms
+    std::vector<int> buckets;
+    for (double ms : samples)
+    {
+        std::size_t bucket = ms < 1.0 ? 0 : static_cast<std::size_t>(std::log2(ms)) + 1;
+        if (bucket >= buckets.size())
+        {
+            buckets.resize(bucket + 1, 0);
+        }
+        buckets[bucket]++;
+    }
+    int widest = *std::max_element(buckets.begin(), buckets.end());
+    std::size_t first = 0;
+    while (buckets[first] == 0)
+    {
+        first++;
+    }
+    for (std::size_t i = first; i < buckets.size(); i++)
+    {
+        std::ostringstream label;
+        if (i == 0)
+            label << "< 1 ms";
+        else
+            label << (1u << (i - 1)) << "-" << (1u << i) << " ms";
+        std::string text = label.str();
+        text.resize(16, ' ');
+        int bar = widest > 0 ? (buckets[i] * 40 + widest - 1) / widest : 0;
+        out << "  " << text << std::string(bar, '#') << " " << buckets[i] << "\n";
+    }
+    return out.str();
+}
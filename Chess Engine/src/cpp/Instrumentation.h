@@ -0,0 +1,98 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where the engine's time goes.
+//
+// The counters the search keeps anyway (nodes, TT probes, cutoffs) are
+// always available in SearchResult. Timing individual phases costs two
+// clock reads per call, so it is only compiled in with
+// -DUSE_INSTRUMENTATION. Without it INSTRUMENT_PHASE expands to nothing
+// and every phase time reads as zero.
+
+// Timed phases. Search time as a whole is SearchResult::seconds.
+enum class Phase
+{
+    MOVEGEN,  // Legal move and capture generation
+    EVAL,     // Static evaluation (including pawn hash probes)
+    BRIDGE    // Waiting on the Prolog and Scheme processes
+};
+
+// Time and calls per phase on one thread
+struct PhaseTimes
+{
+    static const int COUNT = 3;
+
+    uint64_t nanos[COUNT];
+    uint64_t calls[COUNT];
+
+    PhaseTimes() : nanos{}, calls{} {}
+
+    double milliseconds(Phase phase) const { return nanos[static_cast<int>(phase)] / 1e6; }
+
+    PhaseTimes& operator+=(const PhaseTimes& other);
+    PhaseTimes operator-(const PhaseTimes& earlier) const;
+
+    // Running totals for the calling thread
+    static PhaseTimes& thisThread()
+    {
+        thread_local PhaseTimes times;
+        return times;
+    }
+
+    // True if the phase timers were compiled in
+    static bool enabled();
+};
+
+#ifdef USE_INSTRUMENTATION
+// Adds the time until the end of the enclosing scope to one phase
+class PhaseScope
+{
+private:
+    int index;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit PhaseScope(Phase phase)
+        : index(static_cast<int>(phase)), start(std::chrono::steady_clock::now()) {}
+
+    ~PhaseScope()
+    {
+        PhaseTimes& times = PhaseTimes::thisThread();
+        times.nanos[index] += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        times.calls[index]++;
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+
+#define INSTRUMENT_PHASE(phase) PhaseScope instrumentedPhase(phase)
+#else
+#define INSTRUMENT_PHASE(phase) ((void)0)
+#endif
+
+// Per-move latencies, summarised as percentiles and a power-of-two
+// bucket histogram
+class LatencyHistogram
+{
+private:
+    std::vector<double> samples;  // Milliseconds
+
+public:
+    void add(double milliseconds) { samples.push_back(milliseconds); }
+    std::size_t count() const { return samples.size(); }
+
+    // Nearest-rank percentile (p in 0..100); 0 if empty
+    double percentile(double p) const;
+
+    // Multi-line report: count, p50/p95/p99, max and the bucket counts
+    std::string summary() const;
+};
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,87 @@
+#include "MoveGenerator.h"
+#include "BitboardMoveGenerator.h"
+#include "PrologInterface.h"
+#include <utility>
+
+// Derive checkmate and stalemate and index the moves by squares
+PositionStatus::PositionStatus(std::vector<Move> moves, bool check, const Board& board, Color color)
+    : legalMoves(std::move(moves)), inCheck(check), targets{}, pawns(0)
+{
+    const uint8_t* squares = board.pieceSquares(color, PieceType::PAWN);
+    for (int i = 0; i < board.pieceCount(color, PieceType::PAWN); i++)
+    {
+        pawns |= uint64_t(1) << squares[i];
+    }
+    checkmate = inCheck && legalMoves.empty();
+    stalemate = !inCheck && legalMoves.empty();
+    for (const Move& m : legalMoves)
+    {
+        targets[m.fromRow * 8 + m.fromCol] |= uint64_t(1) << (m.toRow * 8 + m.toCol);
+    }
+}
+
+// Set lookup on the squares; the list is only walked for a pawn reaching
+// the last rank, to match the promotion piece
+bool PositionStatus::contains(const Move& move) const
+{
+    if (move.fromRow < 0 || move.fromRow > 7 || move.fromCol < 0 || move.fromCol > 7 ||
+        move.toRow < 0 || move.toRow > 7 || move.toCol < 0 || move.toCol > 7)
+    {
+        return false;
+    }
+    if ((targets[move.fromRow * 8 + move.fromCol] & (uint64_t(1) << (move.toRow * 8 + move.toCol))) == 0)
+    {
+        return false;
+    }
+    bool promoting = (pawns & (uint64_t(1) << (move.fromRow * 8 + move.fromCol))) != 0 &&
+                     (move.toRow == 0 || move.toRow == 7);
+    if (!promoting)
+    {
+        return move.promotion == PieceType::EMPTY;
+    }
+
+    PieceType wanted = (move.promotion == PieceType::EMPTY) ? PieceType::QUEEN : move.promotion;
+    for (const Move& m : legalMoves)
+    {
+        if (m.fromRow == move.fromRow && m.fromCol == move.fromCol &&
+            m.toRow == move.toRow && m.toCol == move.toCol &&
+            (m.promotion == PieceType::EMPTY || m.promotion == wanted))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Two separate questions unless the backend overrides this
+PositionStatus MoveGenerator::positionStatus(const Board& board, Color color) const
+{
+    return PositionStatus(getAllLegalMoves(board, color), isInCheck(board, color), board, color);
+}
+
+// Creates the generator for a backend
+std::unique_ptr<MoveGenerator> createMoveGenerator(MoveBackend backend,
+                                                   const std::string& prologPath)
+{
+    if (backend == MoveBackend::PROLOG)
+    {
+        return std::unique_ptr<MoveGenerator>(new PrologInterface(prologPath));
+    }
+    return std::unique_ptr<MoveGenerator>(new BitboardMoveGenerator());
+}
+
+// Parses a backend name from the command line
+bool parseMoveBackend(const std::string& text, MoveBackend& backend)
+{
+    if (text == "bitboard")
+    {
+        backend = MoveBackend::BITBOARD;
+        return true;
+    }
+    if (text == "prolog")
+    {
+        backend = MoveBackend::PROLOG;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,77 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+
+#include "Board.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Which rules engine answers legality questions for the game
+enum class MoveBackend
+{
+    BITBOARD,  // Native C++ bitboard generator
+    PROLOG     // Reference rules in check_detection.pl
+};
+
+// Everything the game needs to know about one side's position after a
+// move: the legal moves, check, and whether the game is over
+struct PositionStatus
+{
+    std::vector<Move> legalMoves;
+    bool inCheck;
+    bool checkmate;
+    bool stalemate;
+    uint64_t targets[64];  // Bit to of targets[from] set for each legal move
+    uint64_t pawns;        // Squares of the mover's pawns
+
+    PositionStatus() : inCheck(false), checkmate(false), stalemate(false), targets{}, pawns(0) {}
+    PositionStatus(std::vector<Move> moves, bool check, const Board& board, Color color);
+
+    // True if move is one of legalMoves. A promotion piece is only allowed
+    // on a pawn move to the last rank; there, no piece means a queen, and a
+    // backend that does not generate promotions accepts any piece.
+    bool contains(const Move& move) const;
+};
+
+// Common interface for everything that can generate and validate moves
+class MoveGenerator
+{
+public:
+    virtual ~MoveGenerator() = default;
+
+    // Check if a move is legal
+    virtual bool isLegalMove(const Board& board, Color color, const Move& move) const = 0;
+
+    // Check if king is in check
+    virtual bool isInCheck(const Board& board, Color color) const = 0;
+
+    // Check if it's checkmate
+    virtual bool isCheckmate(const Board& board, Color color) const = 0;
+
+    // Get all legal moves for a color
+    virtual std::vector<Move> getAllLegalMoves(const Board& board, Color color) const = 0;
+
+    // Legal moves, check, checkmate and stalemate together. The default
+    // asks getAllLegalMoves and isInCheck; backends where each question is
+    // a round-trip answer in one.
+    virtual PositionStatus positionStatus(const Board& board, Color color) const;
+
+    // A new game starts: forget anything kept about earlier positions
+    virtual void newGame() const {}
+
+    // Short name used in messages and command-line options
+    virtual std::string name() const = 0;
+
+    // True if castling, en passant and promotion are generated
+    virtual bool supportsSpecialMoves() const { return false; }
+};
+
+// Creates the generator for a backend; prologPath is only used by PROLOG
+std::unique_ptr<MoveGenerator> createMoveGenerator(MoveBackend backend,
+                                                   const std::string& prologPath);
+
+// Parses "bitboard" / "prolog"; returns false for anything else
+bool parseMoveBackend(const std::string& text, MoveBackend& backend);
+
+#endif // MOVE_GENERATOR_H
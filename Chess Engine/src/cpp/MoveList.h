@@ -0,0 +1,139 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include "Board.h"
+#include <cassert>
+#include <cstdint>
+
+// A move packed into 16 bits: from square (6), to square (6), flags (4).
+// Squares are row * 8 + col. Used by move generation, search and the
+// transposition table; Move stays the type used at the game/UI level.
+class PackedMove
+{
+private:
+    uint16_t data;
+
+public:
+    // Flag values (standard 4-bit encoding)
+    static const int QUIET            = 0;
+    static const int DOUBLE_PUSH      = 1;
+    static const int KING_CASTLE      = 2;
+    static const int QUEEN_CASTLE     = 3;
+    static const int CAPTURE          = 4;
+    static const int EN_PASSANT       = 5;
+    static const int PROMOTION        = 8;   // +0 knight, +1 bishop, +2 rook, +3 queen
+    static const int PROMOTION_CAPTURE = 12;
+
+    PackedMove() : data(0) {}
+    PackedMove(int from, int to, int flags = QUIET)
+        : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+
+    int from() const { return data & 63; }
+    int to() const { return (data >> 6) & 63; }
+    int flags() const { return data >> 12; }
+
+    bool isNull() const { return data == 0; }
+    bool isCapture() const { return (flags() & CAPTURE) != 0; }
+    bool isPromotion() const { return (flags() & PROMOTION) != 0; }
+
+    // Piece a pawn promotes to (only meaningful if isPromotion())
+    PieceType promotionType() const
+    {
+        static const PieceType TYPES[4] =
+            { PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN };
+        return TYPES[flags() & 3];
+    }
+
+    // Raw 16-bit value, for compact storage
+    uint16_t raw() const { return data; }
+    static PackedMove fromRaw(uint16_t raw)
+    {
+        PackedMove m;
+        m.data = raw;
+        return m;
+    }
+
+    // Promotion flag offset for a piece type (queen for anything else)
+    static int promotionIndex(PieceType type)
+    {
+        switch (type)
+        {
+            case PieceType::KNIGHT: return 0;
+            case PieceType::BISHOP: return 1;
+            case PieceType::ROOK:   return 2;
+            default: return 3;
+        }
+    }
+
+    // Conversion helpers to and from the row/column Move. fromMove has no
+    // board to look at, so the result carries no flags besides a
+    // requested promotion.
+    static PackedMove fromMove(const Move& move)
+    {
+        if (move.fromRow < 0)
+        {
+            return PackedMove();
+        }
+        int flags = (move.promotion == PieceType::EMPTY) ? QUIET : PROMOTION + promotionIndex(move.promotion);
+        return PackedMove(move.fromRow * 8 + move.fromCol, move.toRow * 8 + move.toCol, flags);
+    }
+
+    Move toMove() const
+    {
+        if (isNull())
+        {
+            return Move(-1, -1, -1, -1);
+        }
+        return Move(from() >> 3, from() & 7, to() >> 3, to() & 7,
+                    isPromotion() ? promotionType() : PieceType::EMPTY);
+    }
+
+    // Same squares, ignoring flags
+    bool sameSquares(const PackedMove& other) const { return (data & 0x0FFF) == (other.data & 0x0FFF); }
+
+    bool operator==(const PackedMove& other) const { return data == other.data; }
+    bool operator!=(const PackedMove& other) const { return data != other.data; }
+};
+
+static_assert(sizeof(PackedMove) == 2, "PackedMove must stay 16 bits");
+
+// Fixed-capacity move list that lives on the stack. 218 is the largest
+// number of legal moves in any legal chess position. Board::fromFEN
+// rejects positions outside that (too many pieces, extra promotions),
+// and add() stops at the capacity rather than writing past it, so an
+// unchecked position can lose moves but not corrupt the stack.
+class MoveList
+{
+public:
+    static const int MAX_MOVES = 218;
+
+private:
+    PackedMove moves[MAX_MOVES];
+    int count;
+
+public:
+    MoveList() : count(0) {}
+
+    void add(const PackedMove& move)
+    {
+        assert(count < MAX_MOVES);
+        if (count < MAX_MOVES)
+        {
+            moves[count++] = move;
+        }
+    }
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    PackedMove& operator[](int i) { return moves[i]; }
+    const PackedMove& operator[](int i) const { return moves[i]; }
+
+    PackedMove* begin() { return moves; }
+    PackedMove* end() { return moves + count; }
+    const PackedMove* begin() const { return moves; }
+    const PackedMove* end() const { return moves + count; }
+};
+
+#endif // MOVE_LIST_H
@@ -0,0 +1,135 @@
+#include "MovePicker.h"
+#include <utility>
+
+// Forget every killer
+void KillerTable::clear()
+{
+    for (int ply = 0; ply < MAX_PLY; ply++)
+    {
+        moves[ply][0] = PackedMove();
+        moves[ply][1] = PackedMove();
+    }
+}
+
+// Remember a cutoff move, pushing the older killer to the second slot
+void KillerTable::add(int ply, const PackedMove& move)
+{
+    if (ply >= MAX_PLY || moves[ply][0] == move)
+    {
+        return;
+    }
+    moves[ply][1] = moves[ply][0];
+    moves[ply][0] = move;
+}
+
+// Forget every history score
+void HistoryTable::clear()
+{
+    for (int c = 0; c < 2; c++)
+        for (int from = 0; from < 64; from++)
+            for (int to = 0; to < 64; to++)
+                scores[c][from][to] = 0;
+}
+
+// Halve every score
+void HistoryTable::age()
+{
+    for (int c = 0; c < 2; c++)
+        for (int from = 0; from < 64; from++)
+            for (int to = 0; to < 64; to++)
+                scores[c][from][to] /= 2;
+}
+
+// Credit a quiet move that caused a cutoff; deeper cutoffs count more
+void HistoryTable::reward(Color color, const PackedMove& move, int depth)
+{
+    int& entry = scores[colorIndex(color)][move.from()][move.to()];
+    entry += depth * depth;
+    if (entry > MAX_SCORE)
+    {
+        age();
+    }
+}
+
+// Victim values for MVV-LVA, indexed by PieceType
+static const int VICTIM_VALUE[7] = { 0, 1, 5, 3, 3, 9, 0 };  // EMPTY PAWN ROOK KNIGHT BISHOP QUEEN KING
+
+// Attacker order for MVV-LVA: cheaper attackers first
+static const int ATTACKER_RANK[7] = { 0, 1, 4, 2, 3, 5, 6 };
+
+// Victim value * 8 - attacker rank; a promotion adds the new piece's
+// value as if it were captured, and en passant takes a pawn
+int MovePicker::captureScore(const Board& board, const PackedMove& move)
+{
+    Piece victim = board.getPiece(move.to() >> 3, move.to() & 7);
+    Piece attacker = board.getPiece(move.from() >> 3, move.from() & 7);
+    int gained = VICTIM_VALUE[static_cast<int>(victim.type)];
+    if (move.flags() == PackedMove::EN_PASSANT)
+    {
+        gained = VICTIM_VALUE[static_cast<int>(PieceType::PAWN)];
+    }
+    if (move.isPromotion())
+    {
+        gained += VICTIM_VALUE[static_cast<int>(move.promotionType())];
+    }
+    return gained * 8 - ATTACKER_RANK[static_cast<int>(attacker.type)];
+}
+
+// Sort every move into its stage and give it a score within the stage
+MovePicker::MovePicker(const Board& board, Color color, MoveList& legalMoves, const PackedMove& hashMove,
+                       const PackedMove* killers, const HistoryTable* history)
+    : moves(legalMoves), picked(0), current(Stage::HASH)
+{
+    for (int i = 0; i < moves.size(); i++)
+    {
+        const PackedMove& m = moves[i];
+        if (!hashMove.isNull() && m == hashMove)
+        {
+            stages[i] = Stage::HASH;
+            scores[i] = 0;
+        }
+        else if (m.isCapture() || m.isPromotion())
+        {
+            stages[i] = Stage::CAPTURES;
+            scores[i] = captureScore(board, m);
+        }
+        else if (killers != nullptr && (m == killers[0] || m == killers[1]))
+        {
+            stages[i] = Stage::KILLERS;
+            scores[i] = (m == killers[0]) ? 1 : 0;
+        }
+        else
+        {
+            stages[i] = Stage::QUIETS;
+            scores[i] = (history != nullptr) ? history->score(color, m) : 0;
+        }
+    }
+}
+
+// Pick the best remaining move: earliest stage first, then highest score.
+// The chosen move is swapped into position picked.
+bool MovePicker::next(PackedMove& move)
+{
+    if (picked >= moves.size())
+    {
+        current = Stage::DONE;
+        return false;
+    }
+
+    int best = picked;
+    for (int i = picked + 1; i < moves.size(); i++)
+    {
+        if (stages[i] < stages[best] || (stages[i] == stages[best] && scores[i] > scores[best]))
+        {
+            best = i;
+        }
+    }
+
+    std::swap(moves[picked], moves[best]);
+    std::swap(scores[picked], scores[best]);
+    std::swap(stages[picked], stages[best]);
+    current = stages[picked];
+    move = moves[picked];
+    picked++;
+    return true;
+}
@@ -0,0 +1,102 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "Board.h"
+#include "MoveList.h"
+
+// Quiet moves that caused a beta cutoff, two per ply. A move that refuted
+// one line is often good in the sibling positions at the same ply.
+class KillerTable
+{
+public:
+    static const int MAX_PLY = 128;
+
+private:
+    PackedMove moves[MAX_PLY][2];
+
+public:
+    KillerTable() { clear(); }
+
+    void clear();
+
+    // Remember a cutoff move (newest first, no duplicates)
+    void add(int ply, const PackedMove& move);
+
+    const PackedMove* at(int ply) const { return ply < MAX_PLY ? moves[ply] : nullptr; }
+};
+
+// Butterfly history: how often a quiet move [color][from][to] caused a
+// cutoff, weighted by depth. Used to order the quiet moves left after
+// the killers.
+class HistoryTable
+{
+private:
+    int scores[2][64][64];
+
+public:
+    static const int MAX_SCORE = 1 << 20;
+
+    HistoryTable() { clear(); }
+
+    void clear();
+
+    // Halve every score, so the last search counts more than older ones
+    void age();
+
+    void reward(Color color, const PackedMove& move, int depth);
+
+    int score(Color color, const PackedMove& move) const
+    {
+        return scores[colorIndex(color)][move.from()][move.to()];
+    }
+
+private:
+    static int colorIndex(Color color) { return color == Color::WHITE ? 0 : 1; }
+};
+
+// Hands out the legal moves of a node one at a time, in stages:
+//   1. the transposition table move
+//   2. captures and promotions, most valuable victim first, then least
+//      valuable attacker
+//   3. the killer moves for this ply
+//   4. the remaining quiet moves, by history score
+// Moves are picked lazily (selection of the best remaining one), so a node
+// that cuts off after the first few moves never sorts the rest.
+class MovePicker
+{
+public:
+    enum class Stage
+    {
+        HASH,
+        CAPTURES,
+        KILLERS,
+        QUIETS,
+        DONE
+    };
+
+private:
+    MoveList& moves;
+    int scores[MoveList::MAX_MOVES];
+    Stage stages[MoveList::MAX_MOVES];
+    int picked;      // Moves handed out so far
+    Stage current;   // Stage of the last move handed out
+
+public:
+    // killers and history may be null (no killer / history ordering)
+    MovePicker(const Board& board, Color color, MoveList& legalMoves, const PackedMove& hashMove,
+               const PackedMove* killers, const HistoryTable* history);
+
+    // Next move in order; false once every move has been handed out
+    bool next(PackedMove& move);
+
+    // Stage the last move returned by next() came from
+    Stage stage() const { return current; }
+
+    // Number of moves handed out so far
+    int count() const { return picked; }
+
+    // MVV-LVA score of a capture: victim value * 8 - attacker rank
+    static int captureScore(const Board& board, const PackedMove& move);
+};
+
+#endif // MOVE_PICKER_H
@@ -0,0 +1,94 @@
+#include "ParallelSearch.h"
+#include <thread>
+
+ParallelSearch::ParallelSearch(TranspositionTable& transpositionTable, int threads)
+    : table(transpositionTable), stopFlag(false)
+{
+    setThreads(threads);
+}
+
+// Rebuild the searcher list with one Search per thread
+void ParallelSearch::setThreads(int threads)
+{
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    searchers.clear();
+    for (int i = 0; i < threads; i++)
+    {
+        searchers.emplace_back(new Search(table, &stopFlag));
+        searchers.back()->setThreadIndex(i);
+    }
+    searchers[0]->setIterationCallback(onIteration);
+}
+
+// Report each of thread 0's completed iterations
+void ParallelSearch::setIterationCallback(std::function<void(const SearchResult&)> callback)
+{
+    onIteration = std::move(callback);
+    searchers[0]->setIterationCallback(onIteration);
+}
+
+// Search with every thread and merge the results
+SearchResult ParallelSearch::think(const Board& board, Color color, const SearchLimits& limits)
+{
+    // The stop flag is not cleared here: a stop() that arrives before
+    // this thread gets going must still end the search
+    table.newSearch();
+
+    // Helpers run until thread 0 is done; only the depth cap and the
+    // root move restriction apply to them
+    SearchLimits helperLimits;
+    helperLimits.depth = limits.depth;
+    helperLimits.searchMoves = limits.searchMoves;
+
+    std::vector<SearchResult> helperResults(searchers.size());
+    std::vector<std::thread> helpers;
+    for (std::size_t i = 1; i < searchers.size(); i++)
+    {
+        helpers.emplace_back([this, i, &board, color, &helperLimits, &helperResults]()
+        {
+            helperResults[i] = searchers[i]->think(board, color, helperLimits);
+        });
+    }
+
+    SearchResult result = searchers[0]->think(board, color, limits);
+
+    stop();
+    for (std::thread& t : helpers)
+    {
+        t.join();
+    }
+    clearStop();
+
+    // Merge: totals over all threads, move from the deepest finished iteration
+    result.threads.emplace_back(result.nodes, result.seconds, result.depth);
+    for (std::size_t i = 1; i < helperResults.size(); i++)
+    {
+        const SearchResult& h = helperResults[i];
+        result.threads.emplace_back(h.nodes, h.seconds, h.depth);
+        result.ttProbes += h.ttProbes;
+        result.ttHits += h.ttHits;
+        result.ttStores += h.ttStores;
+        result.ttOverwrites += h.ttOverwrites;
+        result.pawnProbes += h.pawnProbes;
+        result.pawnHits += h.pawnHits;
+        result.betaCutoffs += h.betaCutoffs;
+        result.firstMoveCutoffs += h.firstMoveCutoffs;
+        result.aspirationResearches += h.aspirationResearches;
+        result.nodes += h.nodes;
+        result.qsearchNodes += h.qsearchNodes;
+        result.phases += h.phases;
+
+        if (h.depth > result.depth && h.bestMove.fromRow >= 0)
+        {
+            result.bestMove = h.bestMove;
+            result.score = h.score;
+            result.depth = h.depth;
+            result.pv = h.pv;
+        }
+    }
+    result.hashfull = table.hashfull();
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include "Search.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Lazy SMP: N threads run the same iterative-deepening search on their own
+// copy of the position and share only the transposition table. Entries one
+// thread stores steer and cut the others' trees, which is where the speedup
+// comes from. Thread 0 owns the time budget; when it finishes, the helpers
+// are stopped and the deepest completed result wins.
+class ParallelSearch
+{
+private:
+    TranspositionTable& table;
+    std::atomic<bool> stopFlag;
+    std::vector<std::unique_ptr<Search>> searchers;
+    std::function<void(const SearchResult&)> onIteration;  // Given to thread 0
+
+public:
+    ParallelSearch(TranspositionTable& transpositionTable, int threads = 1);
+
+    // Change the number of search threads (at least 1)
+    void setThreads(int threads);
+    int threadCount() const { return static_cast<int>(searchers.size()); }
+
+    // Progress reports come from thread 0's completed iterations
+    void setIterationCallback(std::function<void(const SearchResult&)> callback);
+
+    // Search with every thread; blocks until the result is ready. Returns
+    // at once if stop() was called since the last search ended.
+    SearchResult think(const Board& board, Color color, const SearchLimits& limits);
+
+    // Ask a running search to finish as soon as possible (thread-safe)
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+
+    // Forget a stop() aimed at an earlier search; call before starting
+    // the thread that runs the next think()
+    void clearStop() { stopFlag.store(false, std::memory_order_relaxed); }
+};
+
+#endif // PARALLEL_SEARCH_H
@@ -0,0 +1,139 @@
+#include "PawnHashTable.h"
+
+static const Bitboard FILE_A = 0x0101010101010101ULL;
+
+// Penalties per doubled (beyond the first on a file) and isolated pawn
+static const int DOUBLED_MG = -10;
+static const int DOUBLED_EG = -20;
+static const int ISOLATED_MG = -10;
+static const int ISOLATED_EG = -15;
+
+// Passed pawn bonus by rank counted from the pawn's own side (0 = first rank)
+static const int PASSED_MG[8] = { 0, 5, 10, 20, 35, 60, 100, 0 };
+static const int PASSED_EG[8] = { 0, 10, 20, 40, 70, 120, 200, 0 };
+
+static Bitboard fileMask(int col) { return FILE_A << col; }
+
+// Files either side of col
+static Bitboard adjacentFiles(int col)
+{
+    return (col > 0 ? fileMask(col - 1) : 0) | (col < 7 ? fileMask(col + 1) : 0);
+}
+
+// Ranks strictly in front of row, as seen by color
+static Bitboard ranksAhead(Color color, int row)
+{
+    if (color == Color::WHITE)
+    {
+        return row < 7 ? ~Bitboard(0) << ((row + 1) * 8) : 0;
+    }
+    return (Bitboard(1) << (row * 8)) - 1;
+}
+
+PawnHashTable::PawnHashTable(std::size_t sizeMB)
+    : probes(0), hits(0)
+{
+    resize(sizeMB);
+}
+
+// Reallocate to the largest power-of-two entry count that fits in sizeMB
+void PawnHashTable::resize(std::size_t sizeMB)
+{
+    std::size_t bytes = (sizeMB == 0 ? 1 : sizeMB) * 1024 * 1024;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(PawnEntry) <= bytes)
+    {
+        count *= 2;
+    }
+    entries = std::vector<PawnEntry>(count);
+    clear();
+}
+
+// Forget every entry. Key 0 with a zero score is the right answer for a
+// board without pawns, so empty slots need no separate marker.
+void PawnHashTable::clear()
+{
+    for (PawnEntry& entry : entries)
+    {
+        entry = PawnEntry();
+    }
+}
+
+// Cached entry for the board's pawns, filled in on a miss
+const PawnEntry& PawnHashTable::probe(const Board& board)
+{
+    uint64_t key = board.pawnHash();
+    PawnEntry& entry = entries[key & (entries.size() - 1)];
+    probes++;
+    if (entry.key == key)
+    {
+        hits++;
+        return entry;
+    }
+    analyse(board, entry);
+    entry.key = key;
+    return entry;
+}
+
+// Doubled, isolated and passed pawns for both sides
+void PawnHashTable::analyse(const Board& board, PawnEntry& entry)
+{
+    Bitboard pawns[2] = { 0, 0 };
+    for (int c = 0; c < 2; c++)
+    {
+        Color color = (c == 0) ? Color::WHITE : Color::BLACK;
+        const uint8_t* list = board.pieceSquares(color, PieceType::PAWN);
+        for (int i = 0; i < board.pieceCount(color, PieceType::PAWN); i++)
+        {
+            pawns[c] |= squareBit(list[i]);
+        }
+    }
+
+    entry.mg = 0;
+    entry.eg = 0;
+    for (int c = 0; c < 2; c++)
+    {
+        Color color = (c == 0) ? Color::WHITE : Color::BLACK;
+        int sign = (c == 0) ? 1 : -1;
+        Bitboard own = pawns[c];
+        Bitboard enemy = pawns[c ^ 1];
+        int mg = 0;
+        int eg = 0;
+
+        for (int col = 0; col < 8; col++)
+        {
+            int count = popCount(own & fileMask(col));
+            if (count > 1)
+            {
+                mg += (count - 1) * DOUBLED_MG;
+                eg += (count - 1) * DOUBLED_EG;
+            }
+            if (count > 0 && !(own & adjacentFiles(col)))
+            {
+                mg += count * ISOLATED_MG;
+                eg += count * ISOLATED_EG;
+            }
+        }
+
+        // Passed: no enemy pawn in front on the same or a neighbouring file
+        entry.passed[c] = 0;
+        Bitboard remaining = own;
+        while (remaining)
+        {
+            int square = popLowestSquare(remaining);
+            int row = rowOf(square);
+            int col = colOf(square);
+            Bitboard span = ranksAhead(color, row) & (fileMask(col) | adjacentFiles(col));
+            if (!(enemy & span))
+            {
+                int rank = (c == 0) ? row : 7 - row;
+                entry.passed[c] |= squareBit(square);
+                mg += PASSED_MG[rank];
+                eg += PASSED_EG[rank];
+            }
+        }
+
+        entry.mg += sign * mg;
+        entry.eg += sign * eg;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef PAWN_HASH_TABLE_H
+#define PAWN_HASH_TABLE_H
+
+#include "Bitboard.h"
+#include "Board.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pawn structure analysis of one position, White minus Black
+struct PawnEntry
+{
+    uint64_t key;         // Board::pawnHash() of the analysed pawns
+    int mg;               // Middlegame score: doubled, isolated and passed pawns
+    int eg;               // Endgame score for the same terms
+    Bitboard passed[2];   // Passed pawns by colorIndex
+
+    PawnEntry() : key(0), mg(0), eg(0), passed{0, 0} {}
+};
+
+// Cache of pawn structure scores, keyed by the pawn-only Zobrist key.
+//
+// Pawns move rarely compared with the other pieces, so sibling nodes of
+// the search almost always share a pawn structure and the analysis is
+// done once for all of them. Each search thread owns its table; there is
+// no locking.
+class PawnHashTable
+{
+private:
+    std::vector<PawnEntry> entries;
+    uint64_t probes;
+    uint64_t hits;
+
+public:
+    // sizeMB is rounded down to a power-of-two number of entries
+    explicit PawnHashTable(std::size_t sizeMB = 1);
+
+    void resize(std::size_t sizeMB);
+    void clear();
+
+    // The entry for the board's pawns, analysing them on a miss
+    const PawnEntry& probe(const Board& board);
+
+    // Probe counters since the last resetStats()
+    uint64_t probeCount() const { return probes; }
+    uint64_t hitCount() const { return hits; }
+    void resetStats() { probes = hits = 0; }
+
+    // Score the pawn structure from scratch
+    static void analyse(const Board& board, PawnEntry& entry);
+};
+
+#endif // PAWN_HASH_TABLE_H
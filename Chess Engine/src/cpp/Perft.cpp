@@ -0,0 +1,336 @@
+#include "Perft.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+
+// Published perft results (chessprogramming.org "Perft Results").
+// specialMoves marks counts that include castling, en passant or
+// promotions, which only a full-rules backend can reproduce.
+struct PerftSuiteEntry
+{
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t expected;
+    bool specialMoves;
+};
+
+static const PerftSuiteEntry PERFT_SUITE[] =
+{
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1, 20ULL, false },
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 2, 400ULL, false },
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8902ULL, false },
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281ULL, false },
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL, true },
+    { "startpos",  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL, true },
+    { "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 1, 48ULL, true },
+    { "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2, 2039ULL, true },
+    { "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862ULL, true },
+    { "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL, true },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 1, 14ULL, false },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 2, 191ULL, false },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3, 2812ULL, true },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238ULL, true },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL, true },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 1, 6ULL, false },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 2, 264ULL, true },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467ULL, true },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL, true },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 1, 44ULL, true },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2, 1486ULL, true },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379ULL, true },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL, true },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 1, 46ULL, false },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 2, 2079ULL, false },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890ULL, false },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL, false },
+};
+
+// Well-formed FENs that Board::fromFEN must still refuse
+struct RejectedFen
+{
+    const char* name;
+    const char* fen;
+};
+
+static const RejectedFen REJECTED_FENS[] =
+{
+    { "two white kings",       "4k3/8/8/8/8/8/8/3KK3 w - - 0 1" },
+    { "no black king",         "8/8/8/8/8/8/8/4K3 w - - 0 1" },
+    { "17 white men",          "4k3/8/8/8/3N4/8/PPPPPPPP/RNBQKBNR w - - 0 1" },
+    { "nine white pawns",      "4k3/8/8/8/8/P7/PPPPPPPP/4K3 w - - 0 1" },
+    { "promotion with 8 pawns", "4k3/8/8/8/8/8/PPPPPPPP/QQ2K3 w - - 0 1" },
+    { "ten queens",            "R5QR/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KBR w - - 0 1" },
+    { "pawn on rank 8",        "P3k3/8/8/8/8/8/8/4K3 w - - 0 1" },
+    { "pawn on rank 1",        "4k3/8/8/8/8/8/8/p3K3 b - - 0 1" },
+    { "side not to move in check", "4k3/8/8/8/8/8/8/4RK2 w - - 0 1" },
+};
+
+static const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+Perft::Perft(const MoveGenerator& moveGenerator)
+    : generator(moveGenerator)
+{
+}
+
+// Number of leaf nodes at the given depth
+uint64_t Perft::count(const Board& board, Color color, int depth) const
+{
+    Board work = board;
+    return countInPlace(work, color, depth);
+}
+
+// Walks the tree on one board, making and unmaking each move
+uint64_t Perft::countInPlace(Board& board, Color color, int depth) const
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+
+    std::vector<Move> moves = generator.getAllLegalMoves(board, color);
+    if (depth == 1)
+    {
+        return moves.size();  // Bulk count at the frontier
+    }
+
+    Color next = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    uint64_t nodes = 0;
+    for (const Move& m : moves)
+    {
+        UndoInfo undo = board.makeMove(m);
+        nodes += countInPlace(board, next, depth - 1);
+        board.unmakeMove(m, undo);
+    }
+    return nodes;
+}
+
+// Leaf counts split by root move
+std::vector<PerftDivideEntry> Perft::divide(const Board& board, Color color, int depth) const
+{
+    std::vector<PerftDivideEntry> entries;
+    Color next = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    Board work = board;
+
+    for (const Move& m : generator.getAllLegalMoves(work, color))
+    {
+        UndoInfo undo = work.makeMove(m);
+        entries.emplace_back(m, countInPlace(work, next, depth - 1));
+        work.unmakeMove(m, undo);
+    }
+    return entries;
+}
+
+// Seconds elapsed since start
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prints node count, time and nodes/second
+static void printSpeed(uint64_t nodes, double seconds)
+{
+    std::cout << "Nodes: " << nodes << "  Time: " << seconds << " s  NPS: "
+              << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << "\n";
+}
+
+// Runs the published suite; returns true if every checked count matches
+static bool runSuite(const MoveGenerator& generator, uint64_t maxNodes)
+{
+    Perft perft(generator);
+    int passed = 0, failed = 0, skipped = 0;
+
+    for (const PerftSuiteEntry& entry : PERFT_SUITE)
+    {
+        std::cout << entry.name << " depth " << entry.depth << ": ";
+
+        if (entry.specialMoves && !generator.supportsSpecialMoves())
+        {
+            std::cout << "SKIP (needs castling/en passant/promotion)\n";
+            skipped++;
+            continue;
+        }
+        if (entry.expected > maxNodes)
+        {
+            std::cout << "SKIP (over --max-nodes)\n";
+            skipped++;
+            continue;
+        }
+
+        Board board;
+        board.fromFEN(entry.fen);
+        Color side = board.sideToMove();
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft.count(board, side, entry.depth);
+        double seconds = secondsSince(start);
+
+        if (nodes == entry.expected)
+        {
+            std::cout << "OK   ";
+            passed++;
+        }
+        else
+        {
+            std::cout << "FAIL expected " << entry.expected << ", ";
+            failed++;
+        }
+        printSpeed(nodes, seconds);
+    }
+
+    for (const RejectedFen& entry : REJECTED_FENS)
+    {
+        Board board;
+        bool accepted = board.fromFEN(entry.fen);
+        std::cout << "reject " << entry.name << ": " << (accepted ? "FAIL accepted\n" : "OK\n");
+        (accepted ? failed : passed)++;
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed, "
+              << skipped << " skipped (" << generator.name() << ")\n";
+    return failed == 0;
+}
+
+// Split perft on two backends, printing only the root moves that differ
+static bool compareBackends(const MoveGenerator& first, const MoveGenerator& second,
+                            const Board& board, Color side, int depth)
+{
+    std::map<std::string, uint64_t> a, b;
+    for (const PerftDivideEntry& e : Perft(first).divide(board, side, depth))
+        a[Board::moveToString(e.move)] = e.nodes;
+    for (const PerftDivideEntry& e : Perft(second).divide(board, side, depth))
+        b[Board::moveToString(e.move)] = e.nodes;
+
+    bool same = true;
+    for (const auto& entry : a)
+    {
+        auto other = b.find(entry.first);
+        if (other == b.end())
+        {
+            std::cout << entry.first << ": " << entry.second << " vs missing\n";
+            same = false;
+        }
+        else if (other->second != entry.second)
+        {
+            std::cout << entry.first << ": " << entry.second << " vs " << other->second << "\n";
+            same = false;
+        }
+    }
+    for (const auto& entry : b)
+    {
+        if (a.find(entry.first) == a.end())
+        {
+            std::cout << entry.first << ": missing vs " << entry.second << "\n";
+            same = false;
+        }
+    }
+
+    std::cout << first.name() << " vs " << second.name() << ": "
+              << (same ? "identical" : "DIFFERENT") << " over "
+              << a.size() << " root moves\n";
+    return same;
+}
+
+static void printPerftUsage()
+{
+    std::cerr << "Usage: chess_game perft [--backend B] [--fen FEN] [--divide] [--compare B] <depth>\n"
+              << "       chess_game perft --suite [--backend B] [--max-nodes N]\n"
+              << "  B is bitboard or prolog\n";
+}
+
+// Entry point for "chess_game perft ..."
+int runPerftCommand(const std::vector<std::string>& args, const std::string& prologPath)
+{
+    MoveBackend backend = MoveBackend::BITBOARD;
+    MoveBackend compareWith = MoveBackend::BITBOARD;
+    bool compare = false;
+    bool divide = false;
+    bool suite = false;
+    uint64_t maxNodes = 5000000;
+    std::string fen = START_FEN;
+    int depth = -1;
+
+    for (std::size_t i = 0; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--backend" && hasValue)
+        {
+            if (!parseMoveBackend(args[++i], backend))
+            {
+                printPerftUsage();
+                return 1;
+            }
+        }
+        else if (arg == "--compare" && hasValue)
+        {
+            if (!parseMoveBackend(args[++i], compareWith))
+            {
+                printPerftUsage();
+                return 1;
+            }
+            compare = true;
+        }
+        else if (arg == "--fen" && hasValue)
+            fen = args[++i];
+        else if (arg == "--max-nodes" && hasValue)
+            maxNodes = std::strtoull(args[++i].c_str(), nullptr, 10);
+        else if (arg == "--divide")
+            divide = true;
+        else if (arg == "--suite")
+            suite = true;
+        else if (!arg.empty() && isdigit(arg[0]))
+            depth = std::atoi(arg.c_str());
+        else
+        {
+            printPerftUsage();
+            return 1;
+        }
+    }
+
+    std::unique_ptr<MoveGenerator> generator = createMoveGenerator(backend, prologPath);
+
+    if (suite)
+    {
+        return runSuite(*generator, maxNodes) ? 0 : 1;
+    }
+
+    Board board;
+    if (depth < 1 || !board.fromFEN(fen))
+    {
+        printPerftUsage();
+        return 1;
+    }
+    Color side = board.sideToMove();
+
+    if (compare)
+    {
+        std::unique_ptr<MoveGenerator> other = createMoveGenerator(compareWith, prologPath);
+        return compareBackends(*generator, *other, board, side, depth) ? 0 : 1;
+    }
+
+    Perft perft(*generator);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+
+    if (divide)
+    {
+        for (const PerftDivideEntry& e : perft.divide(board, side, depth))
+        {
+            std::cout << Board::moveToString(e.move) << ": " << e.nodes << "\n";
+            nodes += e.nodes;
+        }
+        std::cout << "\n";
+    }
+    else
+    {
+        nodes = perft.count(board, side, depth);
+    }
+
+    std::cout << "Backend: " << generator->name() << "  Depth: " << depth << "\n";
+    printSpeed(nodes, secondsSince(start));
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Board.h"
+#include "MoveGenerator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Leaf count below one root move (split perft)
+struct PerftDivideEntry
+{
+    Move move;
+    uint64_t nodes;
+
+    PerftDivideEntry(const Move& m, uint64_t n) : move(m), nodes(n) {}
+};
+
+// Counts the leaf nodes of the legal move tree, driving any MoveGenerator.
+// Used to measure move generation speed and to check it against published
+// counts or against another backend.
+class Perft
+{
+private:
+    const MoveGenerator& generator;
+
+    // count() on a working board that is restored before returning
+    uint64_t countInPlace(Board& board, Color color, int depth) const;
+
+public:
+    explicit Perft(const MoveGenerator& moveGenerator);
+
+    // Number of leaf nodes at the given depth
+    uint64_t count(const Board& board, Color color, int depth) const;
+
+    // Leaf counts split by root move
+    std::vector<PerftDivideEntry> divide(const Board& board, Color color, int depth) const;
+};
+
+// Entry point for "chess_game perft ..."; returns the process exit code
+int runPerftCommand(const std::vector<std::string>& args, const std::string& prologPath);
+
+#endif // PERFT_H
@@ -1,14 +1,32 @@
 #include "PrologInterface.h"
+#include "Instrumentation.h"
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
 #include <array>
 #include <memory>
 #include <algorithm>
-
-PrologInterface::PrologInterface(const std::string& prologFilePath) 
-    : prologPath(prologFilePath) 
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+PrologInterface::PrologInterface(const std::string& prologFilePath, bool persistentSession,
+                                 BridgeFormat bridgeFormat)
+    : prologPath(prologFilePath), persistent(persistentSession),
+      serverPid(-1), toServer(nullptr), fromServer(nullptr),
+      format(bridgeFormat), queries(0), bytesSent(0), bytesReceived(0)
+{
+    // Load the rules once up front instead of on every query
+    if (persistent)
     {
+        startSession();
+    }
+}
+
+PrologInterface::~PrologInterface()
+{
+    stopSession();
 }
 
 // Convert Color enum to Prolog string
@@ -17,37 +35,157 @@ std::string PrologInterface::colorToProlog(Color color)
     return (color == Color::WHITE) ? "white" : "black";
 }
 
-// Execute a Prolog query using subprocess
-std::string PrologInterface::executePrologQuery(const std::string& query) const {
-    std::ostringstream cmd;
-    cmd << "cd " << prologPath << " && "
-        << "swipl -s check_detection.pl"
-        << " -g \"(" << query 
-        << " -> write('SUCCESS') ; write('FAILURE')), halt\" "
-        << "2>&1";
+// Marker query_server.pl prints after the output of every goal
+static const char* const SESSION_END_MARKER = "__END__";
 
-    std::array<char, 128> buffer;
-    std::string result;
+// Start swipl running query_server.pl with pipes on its stdin and stdout
+bool PrologInterface::startSession() const
+{
+    // Both pipes are close-on-exec from the start: a racket server or
+    // popen child forked later must not hold swipl's stdin open, or
+    // stopSession would wait on it. dup2 clears the flag on the copies
+    // the child keeps as its stdin and stdout.
+    int toChild[2];
+    int fromChild[2];
+    if (pipe2(toChild, O_CLOEXEC) != 0)
+    {
+        return false;
+    }
+    if (pipe2(fromChild, O_CLOEXEC) != 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        return false;
+    }
 
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(
-        popen(cmd.str().c_str(), "r"), pclose);
+    // A dead server must show up as a write error, not kill the game
+    signal(SIGPIPE, SIG_IGN);
 
-    if (!pipe) 
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        // Child: wire the pipes to stdin/stdout and become swipl
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0)
+        {
+            dup2(devNull, STDERR_FILENO);
+            close(devNull);
+        }
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+
+        if (chdir(prologPath.c_str()) != 0)
+        {
+            _exit(127);
+        }
+        execlp("swipl", "swipl", "-q", "-s", "query_server.pl",
+               "-g", "serve", "-t", "halt", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    // Parent: keep the write end of stdin and the read end of stdout
+    close(toChild[0]);
+    close(fromChild[1]);
+    serverPid = pid;
+    toServer = fdopen(toChild[1], "w");
+    fromServer = fdopen(fromChild[0], "r");
+    if (toServer == nullptr || fromServer == nullptr)
+    {
+        stopSession();
+        return false;
+    }
+
+    // Round-trip a trivial goal so a missing swipl or a broken rule file
+    // is detected now rather than on the first real query
+    std::string probe = runSessionGoal("write(ready)");
+    if (probe.find("ready") == std::string::npos)
+    {
+        std::cerr << "Warning: Prolog session unavailable, "
+                  << "falling back to one process per query\n";
+        stopSession();
+        return false;
+    }
+    return true;
+}
+
+// Close the pipes and reap the server process
+void PrologInterface::stopSession() const
+{
+    if (toServer != nullptr)
+    {
+        fclose(toServer);  // EOF on stdin ends the serve loop
+        toServer = nullptr;
+    }
+    if (fromServer != nullptr)
+    {
+        fclose(fromServer);
+        fromServer = nullptr;
+    }
+    if (serverPid > 0)
+    {
+        waitpid(serverPid, nullptr, 0);
+        serverPid = -1;
+    }
+}
+
+// Send one goal to the running server and collect its output up to the end marker
+std::string PrologInterface::runSessionGoal(const std::string& goal) const
+{
+    if (toServer == nullptr)
     {
-        std::cerr << "Error: Failed to run Prolog command\n";
         return "";
     }
 
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) 
+    // Goals are read with read_term/3, so they need a full stop
+    if (fputs(goal.c_str(), toServer) < 0 ||
+        fputs(".\n", toServer) < 0 ||
+        fflush(toServer) != 0)
     {
-        result += buffer.data();
+        stopSession();
+        return "";
     }
 
+    std::string result;
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    bool complete = false;
+    while ((length = getline(&line, &capacity, fromServer)) > 0)
+    {
+        std::string text(line, static_cast<std::size_t>(length));
+        if (text == std::string(SESSION_END_MARKER) + "\n")
+        {
+            complete = true;
+            break;
+        }
+        result += text;
+    }
+    free(line);
+
+    // The server closed its output before finishing the answer
+    if (!complete)
+    {
+        stopSession();
+        return "";
+    }
     return result;
 }
 
 // Runs the given goal in an external process and returns its text output
-std::string PrologInterface::executePrologRaw(const std::string& goal) const
+std::string PrologInterface::runOneShot(const std::string& goal) const
 {
     // Build the shell command that changes directory and runs the script
     std::ostringstream cmd;
@@ -67,7 +205,7 @@ std::string PrologInterface::executePrologRaw(const std::string& goal) const
     // If the process failed to start, return an empty result
     if (!pipe)
     {
-        std::cerr << "Error: Failed to run external command (raw)\n";
+        std::cerr << "Error: Failed to run Prolog command\n";
         return "";
     }
 
@@ -81,12 +219,66 @@ std::string PrologInterface::executePrologRaw(const std::string& goal) const
     return result;
 }
 
+// The session tables in_check answers per position; drop them so they
+// only ever cover the game in progress. A one-shot process starts empty.
+void PrologInterface::newGame() const
+{
+    if (toServer != nullptr)
+    {
+        runSessionGoal("new_game");
+    }
+}
+
+// Execute a Prolog query and report SUCCESS or FAILURE
+std::string PrologInterface::executePrologQuery(const std::string& query) const
+{
+    return executePrologRaw("(" + query + " -> write('SUCCESS') ; write('FAILURE'))");
+}
+
+// Runs the given goal and returns its text output
+std::string PrologInterface::executePrologRaw(const std::string& goal) const
+{
+    INSTRUMENT_PHASE(Phase::BRIDGE);
+    std::string result;
+    bool answered = false;
+    if (toServer != nullptr)
+    {
+        result = runSessionGoal(goal);
+        answered = (toServer != nullptr);
+        if (!answered)
+        {
+            std::cerr << "Warning: Prolog session lost, "
+                      << "falling back to one process per query\n";
+        }
+    }
+    if (!answered)
+    {
+        result = runOneShot(goal);
+    }
+
+    queries++;
+    bytesSent += goal.size();
+    bytesReceived += result.size();
+    return result;
+}
+
+// Binds Board to the position: a 64-character atom decoded by
+// wire_board/2, or the full piece(...) list in the text format
+std::string PrologInterface::boardGoal(const Board& board) const
+{
+    if (format == BridgeFormat::TEXT)
+    {
+        return "Board = " + board.toPrologFormat();
+    }
+    return "wire_board('" + board.toCompactString() + "', Board)";
+}
+
 // Check if move is valid
 bool PrologInterface::isValidMove(const Board& board, Color color, 
                                    const Move& move) const 
                                    {
     std::ostringstream query;
-    query << "Board = " << board.toPrologFormat() << ", "
+    query << boardGoal(board) << ", "
           << "valid_move(Board, " << colorToProlog(color) << ", "
           << (move.fromRow + 1) << ", " << (move.fromCol + 1) << ", "
           << (move.toRow + 1) << ", " << (move.toCol + 1) << ")";
@@ -102,7 +294,7 @@ bool PrologInterface::isLegalMove(const Board& board, Color color,
                                    const Move& move) const 
                                    {
     std::ostringstream query;
-    query << "Board = " << board.toPrologFormat() << ", "
+    query << boardGoal(board) << ", "
           << "legal_move(Board, " << colorToProlog(color) << ", "
           << (move.fromRow + 1) << ", " << (move.fromCol + 1) << ", "
           << (move.toRow + 1) << ", " << (move.toCol + 1) << ")";
@@ -115,7 +307,7 @@ bool PrologInterface::isLegalMove(const Board& board, Color color,
 bool PrologInterface::isInCheck(const Board& board, Color color) const 
 {
     std::ostringstream query;
-    query << "Board = " << board.toPrologFormat() << ", "
+    query << boardGoal(board) << ", "
           << "in_check(Board, " << colorToProlog(color) << ")";
     
     std::string result = executePrologQuery(query.str());
@@ -126,70 +318,150 @@ bool PrologInterface::isInCheck(const Board& board, Color color) const
 bool PrologInterface::isCheckmate(const Board& board, Color color) const 
 {
     std::ostringstream query;
-    query << "Board = " << board.toPrologFormat() << ", "
+    query << boardGoal(board) << ", "
           << "is_checkmate(Board, " << colorToProlog(color) << ")";
     
     std::string result = executePrologQuery(query.str());
     return result.find("SUCCESS") != std::string::npos;
 }
 
-// Builds a list of legal moves
-std::vector<Move> PrologInterface::getAllLegalMoves(const Board& board, 
-                                                    Color color) const 
+// Reads one unsigned decimal number at p, advancing past it
+static bool readNumber(const char*& p, const char* end, int& value)
 {
-    std::vector<Move> moves;
-
-    // Construct the goal string that encodes the current board and color
-    std::ostringstream goal;
-    goal << "Board = " << board.toPrologFormat() << ", "
-         << "all_legal_moves(Board, " << colorToProlog(color) << ", Moves), "
-         << "write(Moves)";
-
-    // Run the goal and capture the raw output text
-    std::string result = executePrologRaw(goal.str());
-
-    // Scan through the output for every occurrence of move(FR,FC,TR,TC)
-    std::size_t pos = 0;
-    while (true)
+    if (p == end || *p < '0' || *p > '9')
     {
-        // Find the next "move(" substring
-        std::size_t start = result.find("move(", pos);
-        if (start == std::string::npos)
-            break;
-
-        // Skip past the "move(" prefix
-        start += 5;
+        return false;
+    }
+    value = 0;
+    while (p != end && *p >= '0' && *p <= '9' && value < 100000)
+    {
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    return true;
+}
 
-        // Hold coordinates and punctuation parsed from the text
-        int fr = 0, fc = 0, tr = 0, tc = 0;
-        char c1 = 0, c2 = 0, c3 = 0, closing = 0;
+// Adds from-to to the list unless it is already there
+static void addUnique(MoveList& out, uint64_t (&seen)[64], int from, int to)
+{
+    uint64_t bit = uint64_t(1) << to;
+    if ((seen[from] & bit) == 0 && out.size() < MoveList::MAX_MOVES)
+    {
+        seen[from] |= bit;
+        out.add(PackedMove(from, to));
+    }
+}
 
-        // Parse "FR,FC,TR,TC)" starting at this position
-        std::stringstream ss(result.substr(start));
-        ss >> fr >> c1 >> fc >> c2 >> tr >> c3 >> tc >> closing;
+// Parses "moves: 796 797 ..." (From * 64 + To per move)
+bool PrologInterface::parsePackedMoves(const std::string& text, MoveList& out)
+{
+    out.clear();
+    uint64_t seen[64] = {};
 
-        // If parsing succeeded and the format is correct, store the move
-        if (ss && c1 == ',' && c2 == ',' && c3 == ',' && closing == ')')
+    std::size_t start = text.find("moves:");
+    if (start == std::string::npos)
+    {
+        return false;
+    }
+    const char* p = text.data() + start + 6;
+    const char* end = text.data() + text.size();
+    while (p != end && *p != '\n')
+    {
+        if (*p == ' ' || *p == '\r')
         {
-            // Convert from 1-based indices to 0-based indices
-            moves.emplace_back(fr - 1, fc - 1, tr - 1, tc - 1);
+            ++p;
+            continue;
         }
-
-        // Advance the search position to after this closing parenthesis
-        pos = result.find(")", start);
-        if (pos == std::string::npos)
-            break;
-        ++pos;
+        int code = 0;
+        if (!readNumber(p, end, code) || code >= 64 * 64)
+        {
+            return false;
+        }
+        addUnique(out, seen, code >> 6, code & 63);
     }
-
-    // Return the list of parsed moves
-    return moves;
+    return true;
 }
 
+// Parses every move(FR,FC,TR,TC) term (1-based) in the text
+bool PrologInterface::parseMoveTerms(const std::string& text, MoveList& out)
+{
+    out.clear();
+    uint64_t seen[64] = {};
 
+    const char* end = text.data() + text.size();
+    std::size_t pos = 0;
+    while ((pos = text.find("move(", pos)) != std::string::npos)
+    {
+        const char* p = text.data() + pos + 5;
+        int values[4];
+        bool wellFormed = true;
+        for (int i = 0; i < 4 && wellFormed; i++)
+        {
+            wellFormed = readNumber(p, end, values[i]) && p != end && *p == (i < 3 ? ',' : ')') &&
+                         values[i] >= 1 && values[i] <= 8;
+            if (wellFormed)
+            {
+                ++p;
+            }
+        }
+        if (wellFormed)
+        {
+            addUnique(out, seen, (values[0] - 1) * 8 + (values[1] - 1),
+                      (values[2] - 1) * 8 + (values[3] - 1));
+        }
+        // Carry on after whatever was consumed, so each byte is looked at once
+        pos = static_cast<std::size_t>(p - text.data());
+    }
+    return true;
+}
 
+// Goal that prints Board's legal moves for color in the current format
+std::string PrologInterface::listMovesGoal(Color color) const
+{
+    return "all_legal_moves(Board, " + colorToProlog(color) + ", Moves), " +
+           (format == BridgeFormat::TEXT ? "write(Moves)" : "write_packed_moves(Moves)");
+}
 
+// Reads the moves printed by listMovesGoal
+std::vector<Move> PrologInterface::readMoveList(const std::string& result) const
+{
+    MoveList parsed;
+    if (format == BridgeFormat::TEXT)
+    {
+        parseMoveTerms(result, parsed);
+    }
+    else if (!parsePackedMoves(result, parsed))
+    {
+        std::cerr << "Warning: unreadable move list from Prolog\n";
+    }
 
+    std::vector<Move> moves;
+    moves.reserve(parsed.size());
+    for (const PackedMove& m : parsed)
+    {
+        moves.push_back(m.toMove());
+    }
+    return moves;
+}
 
+// Builds a list of legal moves
+std::vector<Move> PrologInterface::getAllLegalMoves(const Board& board, 
+                                                    Color color) const 
+{
+    // Run the goal and capture the raw output text
+    return readMoveList(executePrologRaw(boardGoal(board) + ", " + listMovesGoal(color)));
+}
 
+// Check and the legal moves in one round-trip: "check:1" or "check:0" on
+// the first line, then the move list
+PositionStatus PrologInterface::positionStatus(const Board& board, Color color) const
+{
+    std::ostringstream goal;
+    goal << boardGoal(board) << ", "
+         << "(in_check(Board, " << colorToProlog(color) << ") -> write('check:1') ; write('check:0')), nl, "
+         << listMovesGoal(color);
 
+    std::string result = executePrologRaw(goal.str());
+    bool check = result.find("check:1") != std::string::npos;
+    return PositionStatus(readMoveList(result), check, board, color);
+}
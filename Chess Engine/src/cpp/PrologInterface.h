@@ -2,39 +2,113 @@
 #define PROLOG_INTERFACE_H
 
 #include "Board.h"
+#include "MoveGenerator.h"
+#include "MoveList.h"
+#include <cstdint>
+#include <cstdio>
 #include <string>
 #include <vector>
+#include <sys/types.h>
 
-class PrologInterface 
+// How positions and move lists cross the bridge
+enum class BridgeFormat
+{
+    COMPACT,  // 64-character board atom, move lists as packed integers
+    TEXT      // piece(...) lists and move(...) terms, easier to read when debugging
+};
+
+// Reference rules engine: answers every question by querying SWI-Prolog
+class PrologInterface : public MoveGenerator
 {
 private:
     std::string prologPath;  // Path to Prolog files
-    
+
+    // Long-lived swipl process running query_server.pl. The rules are
+    // consulted once when it starts; if it cannot be started (or dies)
+    // every query falls back to a fresh swipl process.
+    bool persistent;
+    mutable pid_t serverPid;
+    mutable FILE* toServer;
+    mutable FILE* fromServer;
+
+    BridgeFormat format;
+
+    // Traffic over the bridge, for measuring the wire format
+    mutable uint64_t queries;
+    mutable uint64_t bytesSent;
+    mutable uint64_t bytesReceived;
+
+    // Session management
+    bool startSession() const;
+    void stopSession() const;
+    std::string runSessionGoal(const std::string& goal) const;
+
+    // One-shot fallback: launch swipl for a single goal
+    std::string runOneShot(const std::string& goal) const;
+
     // Helper: Execute a Prolog query and get result
     std::string executePrologQuery(const std::string& query) const;
 
     std::string executePrologRaw(const std::string& goal) const;
-    
+
+    // Goal text that binds Board to the position, in the current format
+    std::string boardGoal(const Board& board) const;
+
+    // Goal text that prints the legal moves, and the reader for its output
+    std::string listMovesGoal(Color color) const;
+    std::vector<Move> readMoveList(const std::string& result) const;
+
 public:
-    PrologInterface(const std::string& prologFilePath);
-    
+    // persistentSession = false restores the old one-process-per-query behaviour
+    PrologInterface(const std::string& prologFilePath, bool persistentSession = true,
+                    BridgeFormat bridgeFormat = BridgeFormat::COMPACT);
+    ~PrologInterface();
+
+    // The session owns a child process, so it cannot be copied
+    PrologInterface(const PrologInterface&) = delete;
+    PrologInterface& operator=(const PrologInterface&) = delete;
+
+    // True if queries are currently served by the long-lived process
+    bool hasSession() const { return toServer != nullptr; }
+
+    // Goals sent and bytes each way since construction
+    uint64_t queryCount() const { return queries; }
+    uint64_t sentBytes() const { return bytesSent; }
+    uint64_t receivedBytes() const { return bytesReceived; }
+
+    // Clear the session's tabled check answers (new_game/0)
+    void newGame() const override;
+
     // Check if a move is valid
     bool isValidMove(const Board& board, Color color, const Move& move) const;
-    
+
     // Check if a move is legal
-    bool isLegalMove(const Board& board, Color color, const Move& move) const;
-    
+    bool isLegalMove(const Board& board, Color color, const Move& move) const override;
+
     // Check if king is in check
-    bool isInCheck(const Board& board, Color color) const;
-    
+    bool isInCheck(const Board& board, Color color) const override;
+
     // Check if it's checkmate
-    bool isCheckmate(const Board& board, Color color) const;
-    
+    bool isCheckmate(const Board& board, Color color) const override;
+
     // Get all legal moves for a color
-    std::vector<Move> getAllLegalMoves(const Board& board, Color color) const;
-    
+    std::vector<Move> getAllLegalMoves(const Board& board, Color color) const override;
+
+    // Check and legal moves from a single query
+    PositionStatus positionStatus(const Board& board, Color color) const override;
+
+    std::string name() const override { return "prolog"; }
+
     // Helper: Convert color enum to string
     static std::string colorToProlog(Color color);
+
+    // Read the moves printed by write_packed_moves/1, or by write/1 of a
+    // move(...) list, into out. One pass and no allocation; duplicates
+    // (which findall can report) are dropped. parsePackedMoves returns
+    // false if the "moves:" line is missing or malformed; parseMoveTerms
+    // skips malformed terms.
+    static bool parsePackedMoves(const std::string& text, MoveList& out);
+    static bool parseMoveTerms(const std::string& text, MoveList& out);
 };
 
 #endif // PROLOG_INTERFACE_H
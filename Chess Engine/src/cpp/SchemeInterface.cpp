@@ -1,17 +1,212 @@
 // SchemeInterface.cpp
 #include "SchemeInterface.h"
+#include "Instrumentation.h"
 
 #include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Loading racket and ai.rkt takes a few hundred milliseconds; allow plenty
+static const int STARTUP_TIMEOUT_MS = 15000;
+
+// Default wait for an answer on top of the move's time budget. ai.rkt only
+// checks its deadline between root moves, so this also covers the last one.
+static const int DEFAULT_REPLY_TIMEOUT_MS = 60000;
 
 // Stores the directory where the Scheme AI script lives
-SchemeInterface::SchemeInterface(const std::string& schemeDir)
-    : schemeDir(schemeDir)
+SchemeInterface::SchemeInterface(const std::string& schemeDir, bool persistentServer)
+    : schemeDir(schemeDir), persistent(persistentServer), replyTimeoutMs(DEFAULT_REPLY_TIMEOUT_MS),
+      serverFailed(false), serverStarted(false), restarts(0),
+      serverPid(-1), toServer(-1), fromServer(-1)
+{
+}
+
+SchemeInterface::~SchemeInterface()
 {
+    stopServer(false);
+}
+
+// Start racket running ai.rkt --server and wait for it to report READY
+bool SchemeInterface::startServer() const
+{
+    int toChild[2];
+    int fromChild[2];
+    if (pipe(toChild) != 0)
+    {
+        return false;
+    }
+    if (pipe(fromChild) != 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        return false;
+    }
+
+    // A dead server must show up as a write error, not kill the game
+    signal(SIGPIPE, SIG_IGN);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        // Child: wire the pipes to stdin/stdout and become racket
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0)
+        {
+            dup2(devNull, STDERR_FILENO);
+            close(devNull);
+        }
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+
+        if (chdir(schemeDir.c_str()) != 0)
+        {
+            _exit(127);
+        }
+        execlp("racket", "racket", "ai.rkt", "--server", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    // Parent: keep the write end of stdin and the read end of stdout. Later
+    // children (the Prolog session, one-shot commands) must not inherit
+    // them, or closing stdin would no longer end the server.
+    close(toChild[0]);
+    close(fromChild[1]);
+    fcntl(toChild[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fromChild[0], F_SETFD, FD_CLOEXEC);
+    serverPid = pid;
+    toServer = toChild[1];
+    fromServer = fromChild[0];
+    readBuffer.clear();
+
+    // A missing racket or a broken ai.rkt is caught here rather than on a move
+    std::string banner;
+    if (readLine(banner, STARTUP_TIMEOUT_MS) != ServerReply::OK || banner != "READY")
+    {
+        stopServer(true);
+        return false;
+    }
+    if (serverStarted)
+    {
+        restarts++;
+    }
+    serverStarted = true;
+    return true;
+}
+
+// Close the pipes and reap the server. force kills it first, for a server
+// that is stuck mid-search and would not notice its stdin closing.
+void SchemeInterface::stopServer(bool force) const
+{
+    if (force && serverPid > 0)
+    {
+        kill(serverPid, SIGKILL);
+    }
+    if (toServer >= 0)
+    {
+        close(toServer);  // EOF on stdin ends the serve loop
+        toServer = -1;
+    }
+    if (fromServer >= 0)
+    {
+        close(fromServer);
+        fromServer = -1;
+    }
+    if (serverPid > 0)
+    {
+        waitpid(serverPid, nullptr, 0);
+        serverPid = -1;
+    }
+    readBuffer.clear();
+}
+
+// Read one line (without its newline) from the server, waiting at most timeoutMs
+SchemeInterface::ServerReply SchemeInterface::readLine(std::string& line, int timeoutMs) const
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true)
+    {
+        std::size_t newline = readBuffer.find('\n');
+        if (newline != std::string::npos)
+        {
+            line = readBuffer.substr(0, newline);
+            readBuffer.erase(0, newline + 1);
+            return ServerReply::OK;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+        {
+            return ServerReply::TIMED_OUT;
+        }
+        pollfd ready = { fromServer, POLLIN, 0 };
+        int polled = poll(&ready, 1, static_cast<int>(remaining));
+        if (polled < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (polled == 0)
+        {
+            return ServerReply::TIMED_OUT;
+        }
+
+        std::array<char, 256> buffer;
+        ssize_t count = read(fromServer, buffer.data(), buffer.size());
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return ServerReply::LOST;
+        }
+        readBuffer.append(buffer.data(), static_cast<std::size_t>(count));
+    }
+}
+
+// Send one length-prefixed request and wait for the one-line answer
+SchemeInterface::ServerReply SchemeInterface::askServer(const std::string& payload, int timeoutMs,
+                                                        std::string& reply) const
+{
+    std::string request = std::to_string(payload.size()) + "\n" + payload;
+    std::size_t written = 0;
+    while (written < request.size())
+    {
+        ssize_t count = write(toServer, request.data() + written, request.size() - written);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return ServerReply::LOST;
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    return readLine(reply, timeoutMs);
 }
 
 // Runs a shell command and returns everything it prints to standard output
@@ -38,15 +233,11 @@ static std::string runCommand(const std::string& cmd)
     return result;
 }
 
-// Asks the Scheme AI to choose a move from a list of legal move strings
-std::string SchemeInterface::chooseMove(const std::string& color,
+// Runs ai.rkt once with the position and moves on its command line
+std::string SchemeInterface::runOneShot(const std::string& color,
                                         const std::string& boardString,
                                         const std::vector<std::string>& legalMoves) const
 {
-    // If there are no legal moves, return an empty string
-    if (legalMoves.empty())
-        return "";
-
     // Build the command that changes into the Scheme directory and runs the script
     std::ostringstream cmd;
     cmd << "cd " << schemeDir << " && ";
@@ -60,7 +251,66 @@ std::string SchemeInterface::chooseMove(const std::string& color,
     cmd << " 2>&1";
 
     // Run the command and capture the AI's output
-    std::string output = runCommand(cmd.str());
+    return runCommand(cmd.str());
+}
+
+// Asks the Scheme AI to choose a move from a list of legal move strings
+std::string SchemeInterface::chooseMove(const std::string& color,
+                                        const std::string& boardString,
+                                        const std::vector<std::string>& legalMoves,
+                                        int timeMs) const
+{
+    INSTRUMENT_PHASE(Phase::BRIDGE);
+
+    // If there are no legal moves, return an empty string
+    if (legalMoves.empty())
+        return "";
+
+    std::string output;
+    bool answered = false;
+    if (persistent && !serverFailed)
+    {
+        // Same fields as the command line, plus the time budget
+        std::ostringstream payload;
+        payload << color << " " << boardString << " " << (timeMs > 0 ? timeMs : 0);
+        for (const auto& m : legalMoves)
+            payload << " " << m;
+
+        // A server that died since the last move gets one restart
+        for (int attempt = 0; attempt < 2 && !answered; attempt++)
+        {
+            if (toServer < 0 && !startServer())
+            {
+                std::cerr << "Warning: Scheme server unavailable, "
+                          << "falling back to one process per move\n";
+                serverFailed = true;
+                break;
+            }
+
+            ServerReply reply = askServer(payload.str(), replyTimeoutMs + (timeMs > 0 ? timeMs : 0), output);
+            if (reply == ServerReply::OK)
+            {
+                answered = true;
+            }
+            else if (reply == ServerReply::TIMED_OUT)
+            {
+                // Asking again would only wait as long; the next move restarts it
+                std::cerr << "Warning: Scheme server timed out, restarting it\n";
+                stopServer(true);
+                return "";
+            }
+            else
+            {
+                std::cerr << "Warning: Scheme server died, restarting it\n";
+                stopServer(true);
+            }
+        }
+    }
+    if (!answered)
+    {
+        output = runOneShot(color, boardString, legalMoves);
+    }
+
     // If nothing came back, treat it as failure
     if (output.empty())
         return "";
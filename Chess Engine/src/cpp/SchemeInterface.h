@@ -3,22 +3,74 @@
 
 #include <string>
 #include <vector>
+#include <sys/types.h>
 
 // Handles communication with the Scheme-based AI player
 class SchemeInterface
 {
 public:
-    // Initializes the interface with the directory that contains ai.rkt
-    explicit SchemeInterface(const std::string& schemeDir);
+    // Initializes the interface with the directory that contains ai.rkt.
+    // persistentServer = false restores the old one-process-per-move behaviour.
+    explicit SchemeInterface(const std::string& schemeDir, bool persistentServer = true);
+    ~SchemeInterface();
 
-    // Chooses a move for the given color and board using the provided legal moves
+    // The server is a child process, so the interface cannot be copied
+    SchemeInterface(const SchemeInterface&) = delete;
+    SchemeInterface& operator=(const SchemeInterface&) = delete;
+
+    // Chooses a move for the given color and board using the provided legal moves.
+    // timeMs > 0 asks ai.rkt to stop after that long (checked between root moves).
     std::string chooseMove(const std::string& color,
                            const std::string& boardString,
-                           const std::vector<std::string>& legalMoves) const;
+                           const std::vector<std::string>& legalMoves,
+                           int timeMs = 0) const;
+
+    // How long to wait for an answer before killing the server, on top of
+    // the move's own time budget
+    void setTimeout(int milliseconds) { replyTimeoutMs = milliseconds; }
+
+    // True if moves are currently answered by the resident ai.rkt
+    bool hasServer() const { return toServer >= 0; }
+
+    // Number of times the server had to be started again after dying or timing out
+    int restartCount() const { return restarts; }
 
 private:
     // Directory path where the Scheme AI script is located
     std::string schemeDir;
+
+    // Resident "racket ai.rkt --server". It is started on the first move
+    // (most games never ask Scheme for one), restarted if it dies or stops
+    // answering, and abandoned for one process per move if it cannot be
+    // started at all.
+    bool persistent;
+    int replyTimeoutMs;
+    mutable bool serverFailed;
+    mutable bool serverStarted;
+    mutable int restarts;
+    mutable pid_t serverPid;
+    mutable int toServer;
+    mutable int fromServer;
+    mutable std::string readBuffer;
+
+    // Outcome of waiting on the server
+    enum class ServerReply
+    {
+        OK,
+        LOST,       // Write failed or output closed: the process died
+        TIMED_OUT   // Still running but silent past the deadline
+    };
+
+    // Server management
+    bool startServer() const;
+    void stopServer(bool force) const;
+    ServerReply readLine(std::string& line, int timeoutMs) const;
+    ServerReply askServer(const std::string& payload, int timeoutMs, std::string& reply) const;
+
+    // One-shot fallback: launch racket for a single move
+    std::string runOneShot(const std::string& color,
+                           const std::string& boardString,
+                           const std::vector<std::string>& legalMoves) const;
 };
 
 #endif
@@ -0,0 +1,556 @@
+#include "Search.h"
+#include "BitboardBoard.h"
+#include "MovePicker.h"
+#include "Zobrist.h"
+#include <algorithm>
+
+Search::Search(TranspositionTable& transpositionTable, std::atomic<bool>* sharedStop)
+    : table(transpositionTable), ownStop(false),
+      stopFlag(sharedStop != nullptr ? sharedStop : &ownStop),
+      managed(sharedStop != nullptr), threadIndex(0),
+      timed(false), aborted(false), nodes(0), qsearchNodes(0),
+      ttProbes(0), ttHits(0), ttStores(0), ttOverwrites(0),
+      betaCutoffs(0), firstMoveCutoffs(0), aspirationResearches(0)
+{
+    Attacks::init();
+}
+
+// Material value of a piece type in centipawns
+static int pieceValue(PieceType type)
+{
+    switch (type)
+    {
+        case PieceType::PAWN:   return 100;
+        case PieceType::KNIGHT: return 320;
+        case PieceType::BISHOP: return 330;
+        case PieceType::ROOK:   return 500;
+        case PieceType::QUEEN:  return 900;
+        case PieceType::KING:   return 20000;
+        default: return 0;
+    }
+}
+
+// Static evaluation from White's point of view: the board's running
+// totals plus the cached pawn structure, tapered by the same phase
+int Search::evaluate(const Board& board)
+{
+    INSTRUMENT_PHASE(Phase::EVAL);
+    const Evaluator& eval = board.evaluation();
+    const PawnEntry& pawns = pawnTable.probe(board);
+    return eval.score() + eval.taper(pawns.mg, pawns.eg);
+}
+
+// Zobrist key of the position including the side to move
+uint64_t Search::positionKey(const Board& board, Color color)
+{
+    return board.hash() ^ (color == Color::BLACK ? Zobrist::sideKey() : 0);
+}
+
+// Mate scores are stored relative to the node, not the root, so they stay
+// correct when the same position is reached at a different ply
+static int scoreToTable(int score, int ply)
+{
+    if (score >= Search::MATE_SCORE - 1000) return score + ply;
+    if (score <= -Search::MATE_SCORE + 1000) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply)
+{
+    if (score >= Search::MATE_SCORE - 1000) return score - ply;
+    if (score <= -Search::MATE_SCORE + 1000) return score + ply;
+    return score;
+}
+
+// Moves the first occurrence of move to the front of the list, keeping
+// the others in order
+static void moveToFront(MoveList& moves, const PackedMove& move)
+{
+    for (int i = 1; i < moves.size(); i++)
+    {
+        if (moves[i] == move)
+        {
+            std::rotate(moves.begin(), moves.begin() + i, moves.begin() + i + 1);
+            return;
+        }
+    }
+}
+
+// Follow the table's best moves from the position after the root move.
+// Each stored move is checked for legality, since a slot may have been
+// overwritten by another position with the same bucket.
+std::vector<Move> Search::principalVariation(Board& board, Color color, const PackedMove& first,
+                                             int maxLength) const
+{
+    std::vector<Move> pv;
+    std::vector<UndoInfo> undos;
+    PackedMove next = first;
+
+    while (!next.isNull() && static_cast<int>(pv.size()) < maxLength)
+    {
+        Move m = next.toMove();
+        pv.push_back(m);
+        undos.push_back(board.makeMove(m));
+        color = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+
+        TTEntry entry;
+        next = PackedMove();
+        if (table.probe(positionKey(board, color), entry) && !entry.bestMove.isNull() &&
+            BitboardBoard(board).isLegalMove(color, entry.bestMove.toMove()))
+        {
+            next = entry.bestMove;
+        }
+    }
+
+    // Take the line back in reverse order
+    for (int i = static_cast<int>(pv.size()) - 1; i >= 0; i--)
+    {
+        board.unmakeMove(pv[i], undos[i]);
+    }
+    return pv;
+}
+
+// Sets aborted once the deadline passes or stop() was called
+void Search::checkTime()
+{
+    if (stopFlag->load(std::memory_order_relaxed) ||
+        (timed && std::chrono::steady_clock::now() >= deadline))
+    {
+        aborted = true;
+    }
+}
+
+// Captures-only search at the horizon, so a position is never judged in
+// the middle of an exchange
+int Search::quiescence(Board& board, Color color, int alpha, int beta, int ply)
+{
+    nodes++;
+    qsearchNodes++;
+
+    if ((nodes & 1023) == 0)
+    {
+        checkTime();
+    }
+    if (aborted)
+    {
+        return 0;
+    }
+
+    // Stand pat: the side to move may decline every capture
+    int eval = evaluate(board);
+    int standPat = (color == Color::WHITE) ? eval : -eval;
+    if (standPat >= beta || ply >= KillerTable::MAX_PLY)
+    {
+        return standPat;
+    }
+    if (standPat > alpha)
+    {
+        alpha = standPat;
+    }
+
+    BitboardBoard position(board);
+    MoveList captures;
+    {
+        INSTRUMENT_PHASE(Phase::MOVEGEN);
+        position.generateLegalCaptures(color, captures);
+    }
+
+    // Most valuable victim first, least valuable attacker next
+    MovePicker picker(board, color, captures, PackedMove(), nullptr, nullptr);
+
+    Color opponent = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    PackedMove packed;
+    while (picker.next(packed))
+    {
+        // Delta pruning: even winning the victim outright cannot raise alpha
+        Piece victim = board.getPiece(packed.to() >> 3, packed.to() & 7);
+        if (standPat + pieceValue(victim.type) + DELTA_MARGIN < alpha)
+        {
+            continue;
+        }
+
+        // Captures that lose material once the exchange is played out
+        if (position.staticExchange(packed) < 0)
+        {
+            continue;
+        }
+
+        Move m = packed.toMove();
+        UndoInfo undo = board.makeMove(m);
+        int score = -quiescence(board, opponent, -beta, -alpha, ply + 1);
+        board.unmakeMove(m, undo);
+
+        if (aborted)
+        {
+            return 0;
+        }
+        if (score >= beta)
+        {
+            return score;
+        }
+        if (score > alpha)
+        {
+            alpha = score;
+        }
+    }
+    return alpha;
+}
+
+// Negamax with alpha-beta pruning
+int Search::negamax(Board& board, Color color, int depth, int alpha, int beta, int ply)
+{
+    // Horizon reached: settle the captures before trusting the evaluation
+    if (depth <= 0)
+    {
+        return quiescence(board, color, alpha, beta, ply);
+    }
+
+    nodes++;
+
+    // Poll the clock every 1024 nodes; once aborted, unwind without storing
+    if ((nodes & 1023) == 0)
+    {
+        checkTime();
+    }
+    if (aborted)
+    {
+        return 0;
+    }
+
+    // A repeated position or fifty reversible moves is a draw. One
+    // repetition is enough inside the tree: the side that wanted it could
+    // repeat again.
+    if (board.repetitionCount() > 0 || board.isFiftyMoveDraw())
+    {
+        return 0;
+    }
+
+    // A deep enough stored result can answer this node outright
+    uint64_t key = positionKey(board, color);
+    TTEntry entry;
+    ttProbes++;
+    bool hit = table.probe(key, entry);
+    if (hit)
+    {
+        ttHits++;
+        if (entry.depth >= depth)
+        {
+            int stored = scoreFromTable(entry.score, ply);
+            if (entry.bound == Bound::EXACT ||
+                (entry.bound == Bound::LOWER && stored >= beta) ||
+                (entry.bound == Bound::UPPER && stored <= alpha))
+            {
+                return stored;
+            }
+        }
+    }
+
+    BitboardBoard position(board);
+    MoveList moves;
+    {
+        INSTRUMENT_PHASE(Phase::MOVEGEN);
+        position.generateLegalMoves(color, moves);
+    }
+
+    // No legal move: checkmate (prefer the quickest) or stalemate
+    if (moves.empty())
+    {
+        return position.isInCheck(color) ? -MATE_SCORE + ply : 0;
+    }
+
+    // Hash move, captures, killers, then quiets by history
+    MovePicker picker(board, color, moves, hit ? entry.bestMove : PackedMove(),
+                      killers.at(ply), &history);
+
+    Color opponent = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    int originalAlpha = alpha;
+    int best = -INFINITE_SCORE;
+    PackedMove bestMove = moves[0];
+    PackedMove packed;
+    while (picker.next(packed))
+    {
+        Move m = packed.toMove();
+        UndoInfo undo = board.makeMove(m);
+        int score = -negamax(board, opponent, depth - 1, -beta, -alpha, ply + 1);
+        board.unmakeMove(m, undo);
+
+        if (aborted)
+        {
+            return 0;
+        }
+
+        if (score > best)
+        {
+            best = score;
+            bestMove = packed;
+        }
+        if (best > alpha)
+        {
+            alpha = best;
+        }
+        if (alpha >= beta)
+        {
+            // The opponent will avoid this line. Quiet refutations become
+            // killers and earn history credit.
+            betaCutoffs++;
+            if (picker.count() == 1)
+            {
+                firstMoveCutoffs++;
+            }
+            if (!packed.isCapture())
+            {
+                killers.add(ply, packed);
+                history.reward(color, packed, depth);
+            }
+            break;
+        }
+    }
+
+    Bound bound = (best >= beta) ? Bound::LOWER
+                : (best > originalAlpha) ? Bound::EXACT : Bound::UPPER;
+    ttStores++;
+    if (table.store(key, scoreToTable(best, ply), depth, bound, bestMove))
+    {
+        ttOverwrites++;
+    }
+    return best;
+}
+
+// Milliseconds to spend on this move
+int Search::allocateTime(const SearchLimits& limits, Color color)
+{
+    if (limits.moveTime > 0)
+    {
+        return limits.moveTime;
+    }
+
+    int remaining = (color == Color::WHITE) ? limits.whiteTime : limits.blackTime;
+    int increment = (color == Color::WHITE) ? limits.whiteInc : limits.blackInc;
+    if (remaining <= 0)
+    {
+        return 0;
+    }
+
+    // Plan for about 30 more moves, spend most of the increment, and never
+    // come closer than 50 ms to flagging
+    int budget = remaining / 30 + increment * 3 / 4;
+    int ceiling = remaining - 50;
+    if (budget > ceiling)
+    {
+        budget = ceiling;
+    }
+    return budget > 1 ? budget : 1;
+}
+
+// Search every root move within (alpha, beta); returns the best score and
+// sets bestMove. Stops at the first move that reaches beta.
+int Search::searchRoot(Board& work, Color color, const MoveList& moves, int depth,
+                       int alpha, int beta, PackedMove& bestMove)
+{
+    Color opponent = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    int bestScore = -INFINITE_SCORE;
+    bestMove = moves[0];
+
+    for (const PackedMove& packed : moves)
+    {
+        Move m = packed.toMove();
+        UndoInfo undo = work.makeMove(m);
+        int score = -negamax(work, opponent, depth - 1, -beta, -alpha, 1);
+        work.unmakeMove(m, undo);
+
+        if (aborted)
+        {
+            break;
+        }
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestMove = packed;
+        }
+        if (score > alpha)
+        {
+            alpha = score;
+        }
+        if (alpha >= beta)
+        {
+            break;
+        }
+    }
+    return bestScore;
+}
+
+// Keep only the root moves listed in allowed. A listed move without a
+// promotion piece accepts any promotion on its squares.
+static void restrictRootMoves(MoveList& moves, const std::vector<Move>& allowed)
+{
+    MoveList kept;
+    for (int i = 0; i < moves.size(); i++)
+    {
+        Move m = moves[i].toMove();
+        for (const Move& a : allowed)
+        {
+            if (a.fromRow == m.fromRow && a.fromCol == m.fromCol &&
+                a.toRow == m.toRow && a.toCol == m.toCol &&
+                (a.promotion == PieceType::EMPTY || a.promotion == m.promotion))
+            {
+                kept.add(moves[i]);
+                break;
+            }
+        }
+    }
+    moves = kept;
+}
+
+// Iterative deepening within the given limits
+SearchResult Search::think(const Board& board, Color color, const SearchLimits& limits)
+{
+    auto start = std::chrono::steady_clock::now();
+    PhaseTimes phasesBefore = PhaseTimes::thisThread();
+    SearchResult result;
+    nodes = 0;
+    qsearchNodes = 0;
+    ttProbes = ttHits = ttStores = ttOverwrites = 0;
+    pawnTable.resetStats();
+    betaCutoffs = firstMoveCutoffs = aspirationResearches = 0;
+    killers.clear();
+    history.age();
+    if (!managed)
+    {
+        table.newSearch();
+        ownStop.store(false, std::memory_order_relaxed);
+    }
+    aborted = false;
+
+    timed = limits.isTimed();
+    if (timed)
+    {
+        deadline = start + std::chrono::milliseconds(allocateTime(limits, color));
+    }
+    int maxDepth = (limits.depth > 0 && limits.depth < MAX_DEPTH) ? limits.depth : MAX_DEPTH;
+
+    Board work = board;
+    MoveList moves;
+    BitboardBoard(work).generateLegalMoves(color, moves);
+    if (!limits.searchMoves.empty())
+    {
+        restrictRootMoves(moves, limits.searchMoves);
+    }
+    if (moves.empty())
+    {
+        return result;
+    }
+
+    // Order the root moves once: a move stored by an earlier search, then
+    // captures, then quiets by history. Later iterations move their best
+    // move to the front.
+    TTEntry rootEntry;
+    table.probe(positionKey(work, color), rootEntry);
+    MovePicker rootOrder(work, color, moves, rootEntry.bestMove, nullptr, &history);
+    PackedMove ordered;
+    while (rootOrder.next(ordered))
+    {
+    }
+    result.bestMove = moves[0].toMove();
+
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        // Helpers skip every other depth, odd and even helpers alternating
+        if (threadIndex > 0 && depth > 1 && depth < maxDepth && (depth + threadIndex) % 2 == 0)
+        {
+            continue;
+        }
+
+        // From depth 4 on, start with a narrow window around the last
+        // score and open the failing side fully if the score falls outside
+        int alpha = -INFINITE_SCORE;
+        int beta = INFINITE_SCORE;
+        if (depth >= 4 && result.score > -MATE_SCORE + MAX_DEPTH && result.score < MATE_SCORE - MAX_DEPTH)
+        {
+            alpha = result.score - ASPIRATION_WINDOW;
+            beta = result.score + ASPIRATION_WINDOW;
+        }
+
+        int iterationScore = -INFINITE_SCORE;
+        PackedMove iterationBest = moves[0];
+        for (;;)
+        {
+            iterationScore = searchRoot(work, color, moves, depth, alpha, beta, iterationBest);
+            if (aborted)
+            {
+                break;
+            }
+            if (iterationScore <= alpha && alpha > -INFINITE_SCORE)
+            {
+                alpha = -INFINITE_SCORE;
+            }
+            else if (iterationScore >= beta && beta < INFINITE_SCORE)
+            {
+                beta = INFINITE_SCORE;
+                moveToFront(moves, iterationBest);
+            }
+            else
+            {
+                break;
+            }
+            aspirationResearches++;
+        }
+
+        // A partial iteration is not trusted; keep the last complete one
+        if (aborted)
+        {
+            break;
+        }
+
+        result.bestMove = iterationBest.toMove();
+        result.score = iterationScore;
+        result.depth = depth;
+        result.pv = principalVariation(work, color, iterationBest, depth);
+
+        if (onIteration)
+        {
+            result.nodes = nodes;
+            result.qsearchNodes = qsearchNodes;
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.hashfull = table.hashfull();
+            onIteration(result);
+        }
+
+        // Next iteration starts with this iteration's best move
+        moveToFront(moves, iterationBest);
+
+        // A forced mate will not change with more depth
+        if (iterationScore >= MATE_SCORE - MAX_DEPTH || iterationScore <= -MATE_SCORE + MAX_DEPTH)
+        {
+            break;
+        }
+        checkTime();
+        if (aborted)
+        {
+            break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.qsearchNodes = qsearchNodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ttProbes = ttProbes;
+    result.ttHits = ttHits;
+    result.ttStores = ttStores;
+    result.ttOverwrites = ttOverwrites;
+    result.pawnProbes = pawnTable.probeCount();
+    result.pawnHits = pawnTable.hitCount();
+    result.betaCutoffs = betaCutoffs;
+    result.firstMoveCutoffs = firstMoveCutoffs;
+    result.aspirationResearches = aspirationResearches;
+    result.hashfull = table.hashfull();
+    result.phases = PhaseTimes::thisThread() - phasesBefore;
+    return result;
+}
+
+// Search the position to a fixed depth
+SearchResult Search::findBestMove(const Board& board, Color color, int depth)
+{
+    SearchLimits limits;
+    limits.depth = depth < 1 ? 1 : depth;
+    return think(board, color, limits);
+}
@@ -0,0 +1,203 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "Board.h"
+#include "Instrumentation.h"
+#include "MovePicker.h"
+#include "PawnHashTable.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// How long the search may run. Zero means "not set" for every field; with
+// nothing set the search runs to MAX_DEPTH.
+struct SearchLimits
+{
+    int depth;      // Maximum plies
+    int moveTime;   // Milliseconds for this move
+    int whiteTime;  // Milliseconds left on the clocks
+    int blackTime;
+    int whiteInc;   // Increment per move in milliseconds
+    int blackInc;
+    std::vector<Move> searchMoves;  // Root moves to consider; empty means all
+
+    SearchLimits()
+        : depth(0), moveTime(0), whiteTime(0), blackTime(0), whiteInc(0), blackInc(0) {}
+
+    bool isTimed() const { return moveTime > 0 || whiteTime > 0 || blackTime > 0; }
+};
+
+// Work done by one thread of a parallel search
+struct SearchThreadStats
+{
+    uint64_t nodes;
+    double seconds;
+    int depth;
+
+    SearchThreadStats(uint64_t n, double s, int d) : nodes(n), seconds(s), depth(d) {}
+
+    double nodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0.0; }
+};
+
+// Outcome of a search: the chosen move and how it was found
+struct SearchResult
+{
+    Move bestMove;      // (-1,-1,-1,-1) if the side to move has no legal move
+    int score;          // Centipawns from the mover's point of view
+    int depth;          // Deepest fully completed iteration
+    uint64_t nodes;     // Positions visited, quiescence included
+    uint64_t qsearchNodes;  // Of those, positions visited by the quiescence search
+    double seconds;     // Wall time spent
+    std::vector<Move> pv;  // Expected line of play, starting with bestMove
+
+    // Transposition table activity during this search
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t ttStores;
+    uint64_t ttOverwrites;  // Stores that evicted a different position
+    int hashfull;           // Permille of the table in use
+
+    // Pawn structure cache activity during this search
+    uint64_t pawnProbes;
+    uint64_t pawnHits;
+
+    // Move ordering quality: how many beta cutoffs came from the first move
+    // searched (ideally over 90%), and root re-searches after the
+    // aspiration window failed
+    uint64_t betaCutoffs;
+    uint64_t firstMoveCutoffs;
+    uint64_t aspirationResearches;
+
+    // Time spent generating moves and evaluating, summed over threads
+    // (zero unless built with USE_INSTRUMENTATION)
+    PhaseTimes phases;
+
+    // One entry per thread (filled in by ParallelSearch)
+    std::vector<SearchThreadStats> threads;
+
+    SearchResult()
+        : bestMove(-1, -1, -1, -1), score(0), depth(0), nodes(0), qsearchNodes(0), seconds(0.0),
+          ttProbes(0), ttHits(0), ttStores(0), ttOverwrites(0), hashfull(0),
+          pawnProbes(0), pawnHits(0),
+          betaCutoffs(0), firstMoveCutoffs(0), aspirationResearches(0) {}
+
+    double pawnHitRate() const
+    {
+        return pawnProbes > 0 ? static_cast<double>(pawnHits) / pawnProbes : 0.0;
+    }
+
+    // Growth of the main search tree per ply: the depth-th root of the
+    // nodes outside quiescence
+    double effectiveBranchingFactor() const
+    {
+        uint64_t mainNodes = nodes - qsearchNodes;
+        return (depth > 0 && mainNodes > 0) ? std::pow(static_cast<double>(mainNodes), 1.0 / depth) : 0.0;
+    }
+
+    double firstMoveCutoffRate() const
+    {
+        return betaCutoffs > 0 ? static_cast<double>(firstMoveCutoffs) / betaCutoffs : 0.0;
+    }
+};
+
+// Native alpha-beta search used by Game::getAIMove.
+// Moves are made and unmade on a single working Board, so no position is
+// copied below the root. Results are cached in a TranspositionTable that
+// may be shared with other Search instances.
+//
+// The search deepens iteratively, one ply at a time, trying the previous
+// iteration's best move first. When the time budget runs out (or stop() is
+// called) the unfinished iteration is abandoned and the last completed one
+// is returned.
+class Search
+{
+private:
+    TranspositionTable& table;
+    std::atomic<bool> ownStop;
+    std::atomic<bool>* stopFlag;  // ownStop, or a flag shared by a group of threads
+    bool managed;                 // Owner resets the stop flag and TT generation
+    int threadIndex;              // 0 for the main thread, >0 for Lazy SMP helpers
+    std::chrono::steady_clock::time_point deadline;
+    bool timed;
+    bool aborted;
+    uint64_t nodes;
+    uint64_t qsearchNodes;
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t ttStores;
+    uint64_t ttOverwrites;
+    uint64_t betaCutoffs;
+    uint64_t firstMoveCutoffs;
+    uint64_t aspirationResearches;
+    KillerTable killers;
+    HistoryTable history;  // Aged, not cleared, between searches
+    PawnHashTable pawnTable;  // Kept between searches
+    std::function<void(const SearchResult&)> onIteration;
+
+    // Zobrist key of the position including the side to move
+    static uint64_t positionKey(const Board& board, Color color);
+
+    // One pass over the root moves within (alpha, beta)
+    int searchRoot(Board& work, Color color, const MoveList& moves, int depth,
+                   int alpha, int beta, PackedMove& bestMove);
+
+    // Negamax with alpha-beta pruning; returns the score for color
+    int negamax(Board& board, Color color, int depth, int alpha, int beta, int ply);
+
+    // Captures-only search below the horizon, with stand pat, delta pruning
+    // and losing captures (by static exchange) skipped
+    int quiescence(Board& board, Color color, int alpha, int beta, int ply);
+
+    // The root move followed by the best moves stored in the table
+    std::vector<Move> principalVariation(Board& board, Color color, const PackedMove& first,
+                                         int maxLength) const;
+
+    // Sets aborted once the deadline passes or stop() was called
+    void checkTime();
+
+    // Milliseconds to spend on this move given the limits
+    static int allocateTime(const SearchLimits& limits, Color color);
+
+public:
+    static const int INFINITE_SCORE = 1000000;
+    static const int MATE_SCORE = 100000;
+    static const int MAX_DEPTH = 64;
+    static const int ASPIRATION_WINDOW = 50;  // Half-width of the root window in centipawns
+    static const int DELTA_MARGIN = 200;      // Slack for positional gains in delta pruning
+
+    // With sharedStop set, the search is one of a group run by ParallelSearch:
+    // the owner clears the flag and starts the TT generation before each search
+    explicit Search(TranspositionTable& transpositionTable,
+                    std::atomic<bool>* sharedStop = nullptr);
+
+    // Helpers (index > 0) vary which depths they search so the threads
+    // spread over different parts of the tree
+    void setThreadIndex(int index) { threadIndex = index; }
+
+    // Called from the searching thread after every completed iteration
+    // with the result so far (used for UCI "info" lines)
+    void setIterationCallback(std::function<void(const SearchResult&)> callback)
+    {
+        onIteration = std::move(callback);
+    }
+
+    // Iterative deepening within the given limits; returns the best move for color
+    SearchResult think(const Board& board, Color color, const SearchLimits& limits);
+
+    // Search the position to a fixed depth and return the best move for color
+    SearchResult findBestMove(const Board& board, Color color, int depth);
+
+    // Ask a running search to finish as soon as possible (thread-safe)
+    void stop() { stopFlag->store(true, std::memory_order_relaxed); }
+
+    // Static evaluation from White's point of view: the board's tapered
+    // material and piece-square totals (see Evaluator) plus the pawn
+    // structure, looked up in this search's pawn hash table
+    int evaluate(const Board& board);
+};
+
+#endif // SEARCH_H
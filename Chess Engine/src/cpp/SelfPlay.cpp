@@ -0,0 +1,561 @@
+#include "SelfPlay.h"
+#include "Board.h"
+#include "Game.h"
+#include "MoveGenerator.h"
+#include "SchemeInterface.h"
+#include "Search.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Short, common openings in coordinate notation
+struct Opening
+{
+    const char* name;
+    const char* moves;
+};
+
+static const Opening OPENINGS[] =
+{
+    { "Italian Game",              "e2e4 e7e5 g1f3 b8c6 f1c4 f8c5" },
+    { "Ruy Lopez",                 "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6" },
+    { "Sicilian Defence",          "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4" },
+    { "French Defence",            "e2e4 e7e6 d2d4 d7d5 b1c3 g8f6" },
+    { "Caro-Kann Defence",         "e2e4 c7c6 d2d4 d7d5 b1c3 d5e4" },
+    { "Pirc Defence",              "e2e4 d7d6 d2d4 g8f6 b1c3 g7g6" },
+    { "Scandinavian Defence",      "e2e4 d7d5 e4d5 d8d5 b1c3 d5a5" },
+    { "Queen's Gambit Declined",   "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6" },
+    { "Slav Defence",              "d2d4 d7d5 c2c4 c7c6 g1f3 g8f6" },
+    { "King's Indian Defence",     "d2d4 g8f6 c2c4 g7g6 b1c3 f8g7" },
+    { "Nimzo-Indian Defence",      "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4" },
+    { "English Opening",           "c2c4 e7e5 b1c3 g8f6 g2g3 d7d5" },
+    { "Reti Opening",              "g1f3 d7d5 c2c4 e7e6 g2g3 g8f6" },
+    { "Dutch Defence",             "d2d4 f7f5 g2g3 g8f6 f1g2 e7e6" },
+};
+
+static const int OPENING_COUNT = sizeof(OPENINGS) / sizeof(OPENINGS[0]);
+
+// Games with no result after this many plies are adjudicated a draw
+static const int MAX_PLIES = 400;
+
+// One side of the match
+struct EngineSpec
+{
+    std::string name;
+    AiBackend ai;
+    SearchLimits limits;  // depth, movetime, or a clock (time + increment)
+    int hashMB;
+
+    EngineSpec() : ai(AiBackend::NATIVE), hashMB(16)
+    {
+        limits.depth = 4;
+    }
+};
+
+// How a finished game went
+struct GameRecord
+{
+    int round;
+    bool firstIsWhite;
+    const Opening* opening;
+    std::vector<std::string> sanMoves;
+    std::string result;       // "1-0", "0-1" or "1/2-1/2"
+    std::string termination;  // Why the game ended
+};
+
+// Parses "native,depth=5" / "native,movetime=100" / "native,time=60000,inc=500"
+// / "scheme" with an optional "hash=MB" and "name=..."
+static bool parseEngineSpec(const std::string& text, EngineSpec& spec)
+{
+    spec = EngineSpec();
+    bool depthGiven = false;
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, ','))
+    {
+        std::size_t eq = field.find('=');
+        std::string key = field.substr(0, eq);
+        std::string value = (eq == std::string::npos) ? "" : field.substr(eq + 1);
+        int number = std::atoi(value.c_str());
+
+        if (key == "native")
+            spec.ai = AiBackend::NATIVE;
+        else if (key == "scheme")
+            spec.ai = AiBackend::SCHEME;
+        else if (key == "depth" && number > 0)
+        {
+            spec.limits.depth = number;
+            depthGiven = true;
+        }
+        else if (key == "movetime" && number > 0)
+            spec.limits.moveTime = number;
+        else if (key == "time" && number > 0)
+            spec.limits.whiteTime = spec.limits.blackTime = number;
+        else if (key == "inc" && number >= 0)
+            spec.limits.whiteInc = spec.limits.blackInc = number;
+        else if (key == "hash" && number > 0)
+            spec.hashMB = number;
+        else if (key == "name" && !value.empty())
+            spec.name = value;
+        else
+            return false;
+    }
+
+    // With a time budget the depth is only a cap if it was asked for
+    if (spec.limits.isTimed() && !depthGiven)
+    {
+        spec.limits.depth = 0;
+    }
+    if (spec.name.empty())
+    {
+        spec.name = text;
+    }
+    return true;
+}
+
+// An engine instance for one game: its own search and table, or ai.rkt
+class Player
+{
+private:
+    const EngineSpec& spec;
+    TranspositionTable table;
+    Search search;
+    SchemeInterface scheme;
+    SearchLimits limits;  // Copy, so the clock can run down
+
+public:
+    Player(const EngineSpec& engineSpec, const std::string& schemePath)
+        : spec(engineSpec), table(engineSpec.ai == AiBackend::NATIVE ? engineSpec.hashMB : 1),
+          search(table), scheme(schemePath), limits(engineSpec.limits)
+    {
+    }
+
+    // Pick a move from the legal ones; (-1,-1,-1,-1) if the engine gave none
+    Move choose(const Board& board, Color color, const std::vector<Move>& legal)
+    {
+        if (spec.ai == AiBackend::SCHEME)
+        {
+            std::vector<std::string> moveStrings;
+            for (const Move& m : legal)
+            {
+                moveStrings.push_back(Board::moveToString(m));
+            }
+            std::string chosen = scheme.chooseMove(Board::colorToString(color),
+                                                   board.toSchemeString(), moveStrings, limits.moveTime);
+            for (const Move& m : legal)
+            {
+                if (Board::moveToString(m) == chosen)
+                {
+                    return m;
+                }
+            }
+            return Move(-1, -1, -1, -1);
+        }
+
+        // Only moves the rules backend accepts: its rules may be narrower
+        // than the native generator's (Prolog has no castling or en passant)
+        limits.searchMoves = legal;
+        SearchResult result = search.think(board, color, limits);
+
+        // Charge the clock for the time spent, as Game::getAIMove does
+        int spentMs = static_cast<int>(result.seconds * 1000.0);
+        int& clock = (color == Color::WHITE) ? limits.whiteTime : limits.blackTime;
+        if (clock > 0)
+        {
+            clock += ((color == Color::WHITE) ? limits.whiteInc : limits.blackInc) - spentMs;
+            if (clock < 1) clock = 1;
+        }
+        return result.bestMove;
+    }
+};
+
+// Standard algebraic notation for a legal move (check marks are added by
+// the caller once the reply position is known)
+static std::string toSAN(const Board& board, const std::vector<Move>& legal, const Move& move)
+{
+    static const char LETTERS[] = " PRNBQK";
+    Piece piece = board.getPiece(move.fromRow, move.fromCol);
+    bool capture = !board.getPiece(move.toRow, move.toCol).isEmpty() ||
+                   (piece.type == PieceType::PAWN && move.fromCol != move.toCol);  // En passant
+    std::string san;
+
+    if (piece.type == PieceType::KING && (move.toCol - move.fromCol == 2 || move.fromCol - move.toCol == 2))
+    {
+        return move.toCol > move.fromCol ? "O-O" : "O-O-O";
+    }
+    if (piece.type == PieceType::PAWN)
+    {
+        if (capture)
+        {
+            san += static_cast<char>('a' + move.fromCol);
+        }
+    }
+    else
+    {
+        san += LETTERS[static_cast<int>(piece.type)];
+
+        // Name the file, rank or both if another piece of the same kind
+        // could also reach the square
+        bool ambiguous = false;
+        bool sameFile = false;
+        bool sameRank = false;
+        for (const Move& other : legal)
+        {
+            if (other.toRow != move.toRow || other.toCol != move.toCol ||
+                (other.fromRow == move.fromRow && other.fromCol == move.fromCol) ||
+                board.getPiece(other.fromRow, other.fromCol).type != piece.type)
+            {
+                continue;
+            }
+            ambiguous = true;
+            sameFile |= (other.fromCol == move.fromCol);
+            sameRank |= (other.fromRow == move.fromRow);
+        }
+        if (ambiguous)
+        {
+            if (!sameFile)
+            {
+                san += static_cast<char>('a' + move.fromCol);
+            }
+            else if (!sameRank)
+            {
+                san += static_cast<char>('1' + move.fromRow);
+            }
+            else
+            {
+                san += static_cast<char>('a' + move.fromCol);
+                san += static_cast<char>('1' + move.fromRow);
+            }
+        }
+    }
+
+    if (capture)
+    {
+        san += 'x';
+    }
+    san += static_cast<char>('a' + move.toCol);
+    san += static_cast<char>('1' + move.toRow);
+    if (piece.type == PieceType::PAWN && (move.toRow == 0 || move.toRow == 7))
+    {
+        san += '=';
+        san += LETTERS[static_cast<int>(move.promotion == PieceType::EMPTY ? PieceType::QUEEN : move.promotion)];
+    }
+    return san;
+}
+
+// Parse "e2e4" from an opening line
+static Move parseCoordinate(const std::string& text)
+{
+    return Move(text[1] - '1', text[0] - 'a', text[3] - '1', text[2] - 'a');
+}
+
+// Play one game between the two engines
+static GameRecord playGame(int round, const EngineSpec& first, const EngineSpec& second,
+                           MoveBackend rulesBackend, const std::string& prologPath,
+                           const std::string& schemePath)
+{
+    GameRecord record;
+    record.round = round;
+    record.firstIsWhite = (round % 2 == 0);                 // Colors alternate every game
+    record.opening = &OPENINGS[(round / 2) % OPENING_COUNT];  // Each opening twice
+
+    std::unique_ptr<MoveGenerator> rules = createMoveGenerator(rulesBackend, prologPath);
+    rules->newGame();
+    Player firstPlayer(first, schemePath);
+    Player secondPlayer(second, schemePath);
+    Player& white = record.firstIsWhite ? firstPlayer : secondPlayer;
+    Player& black = record.firstIsWhite ? secondPlayer : firstPlayer;
+
+    Board board;
+
+    std::istringstream book(record.opening->moves);
+    std::string bookMove;
+
+    for (;;)
+    {
+        Color side = board.sideToMove();
+        PositionStatus status = rules->positionStatus(board, side);
+        const std::vector<Move>& legal = status.legalMoves;
+        bool inCheck = status.inCheck;
+
+        // Mark the previous move as check or mate
+        if (inCheck && !record.sanMoves.empty())
+        {
+            record.sanMoves.back() += legal.empty() ? "#" : "+";
+        }
+
+        if (legal.empty())
+        {
+            if (inCheck)
+            {
+                record.result = (side == Color::WHITE) ? "0-1" : "1-0";
+                record.termination = (side == Color::WHITE) ? "Black mates" : "White mates";
+            }
+            else
+            {
+                record.result = "1/2-1/2";
+                record.termination = "Stalemate";
+            }
+            break;
+        }
+        if (board.isFiftyMoveDraw())
+        {
+            record.result = "1/2-1/2";
+            record.termination = "Fifty-move rule";
+            break;
+        }
+        if (board.repetitionCount() >= 2)
+        {
+            record.result = "1/2-1/2";
+            record.termination = "Threefold repetition";
+            break;
+        }
+        if (board.isInsufficientMaterial())
+        {
+            record.result = "1/2-1/2";
+            record.termination = "Insufficient material";
+            break;
+        }
+        if (static_cast<int>(record.sanMoves.size()) >= MAX_PLIES)
+        {
+            record.result = "1/2-1/2";
+            record.termination = "Adjudicated draw after " + std::to_string(MAX_PLIES) + " plies";
+            break;
+        }
+
+        // Book moves first, then the engines
+        Move move(-1, -1, -1, -1);
+        if (book >> bookMove)
+        {
+            move = parseCoordinate(bookMove);
+        }
+        else
+        {
+            move = (side == Color::WHITE ? white : black).choose(board, side, legal);
+        }
+
+        // A promotion with no piece named means a queen; a backend that
+        // lists promotions without a piece accepts any
+        if (!status.contains(move))
+        {
+            record.result = (side == Color::WHITE) ? "0-1" : "1-0";
+            record.termination = Board::colorToString(side) + " made an illegal move";
+            break;
+        }
+
+        record.sanMoves.push_back(toSAN(board, legal, move));
+        board.executeMove(move);
+    }
+    return record;
+}
+
+// Write one game as PGN
+static void writePGN(std::ostream& out, const GameRecord& record,
+                     const EngineSpec& first, const EngineSpec& second, const std::string& date)
+{
+    const EngineSpec& white = record.firstIsWhite ? first : second;
+    const EngineSpec& black = record.firstIsWhite ? second : first;
+
+    out << "[Event \"Self-play\"]\n"
+        << "[Site \"?\"]\n"
+        << "[Date \"" << date << "\"]\n"
+        << "[Round \"" << (record.round + 1) << "\"]\n"
+        << "[White \"" << white.name << "\"]\n"
+        << "[Black \"" << black.name << "\"]\n"
+        << "[Result \"" << record.result << "\"]\n"
+        << "[Opening \"" << record.opening->name << "\"]\n"
+        << "[Termination \"" << record.termination << "\"]\n\n";
+
+    // Movetext, wrapped before 80 columns
+    std::string line;
+    for (std::size_t i = 0; i < record.sanMoves.size(); i++)
+    {
+        std::string token;
+        if (i % 2 == 0)
+        {
+            token = std::to_string(i / 2 + 1) + ". ";
+        }
+        token += record.sanMoves[i];
+        if (line.size() + token.size() + 1 > 79)
+        {
+            out << line << "\n";
+            line.clear();
+        }
+        line += (line.empty() ? "" : " ") + token;
+    }
+    std::string result = record.result;
+    if (line.size() + result.size() + 1 > 79)
+    {
+        out << line << "\n";
+        line.clear();
+    }
+    out << line << (line.empty() ? "" : " ") << result << "\n\n";
+}
+
+// Elo difference for an expected score between 0 and 1
+static double eloFromScore(double score)
+{
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Win/draw/loss summary with the Elo difference and its 95% margin
+static void printMatchStats(const EngineSpec& first, const EngineSpec& second,
+                            int wins, int draws, int losses)
+{
+    int games = wins + draws + losses;
+    std::cout << "\n" << first.name << " vs " << second.name << ": "
+              << "+" << wins << " =" << draws << " -" << losses << " (" << games << " games)\n";
+    if (games == 0)
+    {
+        return;
+    }
+
+    double w = static_cast<double>(wins) / games;
+    double d = static_cast<double>(draws) / games;
+    double l = static_cast<double>(losses) / games;
+    double score = w + d / 2;
+    std::cout << "Score: " << (100.0 * score) << "%";
+
+    if (score <= 0.0 || score >= 1.0)
+    {
+        std::cout << "  Elo difference: " << (score > 0.5 ? "+inf" : "-inf") << "\n";
+        return;
+    }
+
+    // Standard deviation of the per-game score, then the 95% interval
+    double deviation = std::sqrt((w * (1 - score) * (1 - score) +
+                                  d * (0.5 - score) * (0.5 - score) +
+                                  l * score * score) / games);
+    double low = std::max(score - 1.959964 * deviation, 1e-6);
+    double high = std::min(score + 1.959964 * deviation, 1 - 1e-6);
+    double margin = (eloFromScore(high) - eloFromScore(low)) / 2;
+
+    std::cout.setf(std::ios::fixed);
+    std::cout.precision(1);
+    std::cout << "  Elo difference: " << eloFromScore(score) << " +/- " << margin << "\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(6);
+}
+
+// Print usage for the selfplay subcommand
+static void printSelfPlayUsage()
+{
+    std::cerr << "Usage: chess_game selfplay [--games M] [--concurrency T] [--pgn FILE]\n"
+              << "                           [--first SPEC] [--second SPEC] [--backend bitboard|prolog]\n"
+              << "  SPEC is a comma list: native|scheme, depth=N, movetime=MS,\n"
+              << "  time=MS, inc=MS, hash=MB, name=NAME  (default native,depth=4)\n";
+}
+
+// Entry point for "chess_game selfplay ..."
+int runSelfPlayCommand(const std::vector<std::string>& args,
+                       const std::string& prologPath, const std::string& schemePath)
+{
+    int games = 10;
+    int concurrency = 1;
+    std::string pgnPath = "selfplay.pgn";
+    MoveBackend rulesBackend = MoveBackend::BITBOARD;
+    EngineSpec first;
+    EngineSpec second;
+    parseEngineSpec("native,depth=4,name=first", first);
+    parseEngineSpec("native,depth=4,name=second", second);
+
+    for (std::size_t i = 0; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--games" && hasValue)
+            games = std::max(1, std::atoi(args[++i].c_str()));
+        else if (arg == "--concurrency" && hasValue)
+            concurrency = std::max(1, std::atoi(args[++i].c_str()));
+        else if (arg == "--pgn" && hasValue)
+            pgnPath = args[++i];
+        else if (arg == "--backend" && hasValue)
+        {
+            if (!parseMoveBackend(args[++i], rulesBackend))
+            {
+                printSelfPlayUsage();
+                return 1;
+            }
+        }
+        else if ((arg == "--first" || arg == "--second") && hasValue)
+        {
+            if (!parseEngineSpec(args[++i], arg == "--first" ? first : second))
+            {
+                printSelfPlayUsage();
+                return 1;
+            }
+        }
+        else
+        {
+            printSelfPlayUsage();
+            return 1;
+        }
+    }
+
+    std::ofstream pgn(pgnPath);
+    if (!pgn)
+    {
+        std::cerr << "Cannot write " << pgnPath << "\n";
+        return 1;
+    }
+
+    char date[16];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+
+    std::atomic<int> nextRound(0);
+    std::mutex resultMutex;  // Guards the counters, the PGN file and stdout
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    int finished = 0;
+
+    auto worker = [&]()
+    {
+        for (int round = nextRound++; round < games; round = nextRound++)
+        {
+            GameRecord record = playGame(round, first, second, rulesBackend, prologPath, schemePath);
+
+            // Result from the first engine's point of view
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (record.result == "1/2-1/2")
+                draws++;
+            else if ((record.result == "1-0") == record.firstIsWhite)
+                wins++;
+            else
+                losses++;
+            finished++;
+
+            writePGN(pgn, record, first, second, date);
+            pgn.flush();
+            std::cout << "Game " << finished << "/" << games << " (round " << (record.round + 1) << ", "
+                      << (record.firstIsWhite ? first.name + " - " + second.name
+                                              : second.name + " - " + first.name)
+                      << "): " << record.result << " {" << record.termination << "}  "
+                      << "+" << wins << " =" << draws << " -" << losses << "\n";
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < std::min(concurrency, games); i++)
+    {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& t : pool)
+    {
+        t.join();
+    }
+
+    printMatchStats(first, second, wins, draws, losses);
+    std::cout << "PGN written to " << pgnPath << "\n";
+    return 0;
+}
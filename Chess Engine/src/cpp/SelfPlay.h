@@ -0,0 +1,20 @@
+#ifndef SELF_PLAY_H
+#define SELF_PLAY_H
+
+#include <string>
+#include <vector>
+
+// Engine-vs-engine matches ("chess_game selfplay ...").
+//
+// Two engine configurations play a series of games, several at once on a
+// pool of threads. Each game starts from an opening of the built-in book,
+// and every opening is played twice with colors reversed so neither side
+// profits from a lopsided line. Games are written as PGN, and the match
+// ends with win/draw/loss counts and the Elo difference (with a 95% error
+// margin) from the first engine's point of view.
+
+// Entry point for "chess_game selfplay ..."; returns the process exit code
+int runSelfPlayCommand(const std::vector<std::string>& args,
+                       const std::string& prologPath, const std::string& schemePath);
+
+#endif // SELF_PLAY_H
@@ -0,0 +1,147 @@
+#include "TranspositionTable.h"
+
+// Packed data word layout:
+//   bits  0-15  best move (PackedMove)   bits 16-17  bound
+//   bits 18-25  depth                    bits 26-33  generation
+//   bits 40-63  score (24-bit two's complement)
+static uint64_t pack(int score, int depth, Bound bound, const PackedMove& move, uint8_t generation)
+{
+    uint64_t data = move.raw();
+    data |= static_cast<uint64_t>(bound) << 16;
+    data |= static_cast<uint64_t>(depth < 0 ? 0 : (depth > 255 ? 255 : depth)) << 18;
+    data |= static_cast<uint64_t>(generation) << 26;
+    data |= static_cast<uint64_t>(static_cast<uint32_t>(score) & 0xFFFFFF) << 40;
+    return data;
+}
+
+static Bound boundOf(uint64_t data) { return static_cast<Bound>((data >> 16) & 3); }
+static int depthOf(uint64_t data) { return static_cast<int>((data >> 18) & 0xFF); }
+static uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> 26); }
+static PackedMove moveOf(uint64_t data) { return PackedMove::fromRaw(static_cast<uint16_t>(data)); }
+
+static void unpack(uint64_t data, TTEntry& entry)
+{
+    // Shift the score to the top and back to sign-extend it
+    entry.score = static_cast<int>(static_cast<int64_t>(data) >> 40);
+    entry.depth = depthOf(data);
+    entry.bound = boundOf(data);
+    entry.bestMove = moveOf(data);
+}
+
+TranspositionTable::TranspositionTable(std::size_t sizeMB)
+    : generation(0)
+{
+    resize(sizeMB);
+}
+
+// Reallocate to the largest power-of-two bucket count that fits in sizeMB
+void TranspositionTable::resize(std::size_t sizeMB)
+{
+    std::size_t bytes = (sizeMB == 0 ? 1 : sizeMB) * 1024 * 1024;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+    {
+        count *= 2;
+    }
+    buckets = std::vector<Bucket>(count);
+    clear();
+}
+
+// Forget every stored position
+void TranspositionTable::clear()
+{
+    for (Bucket& bucket : buckets)
+    {
+        for (Slot& slot : bucket.slots)
+        {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+// Look the key up in its bucket
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const
+{
+    const Bucket& bucket = buckets[key & (buckets.size() - 1)];
+    for (const Slot& slot : bucket.slots)
+    {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && boundOf(data) != Bound::NONE)
+        {
+            unpack(data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Store a result, replacing the same position, an empty slot, or the
+// shallowest / oldest entry in the bucket
+bool TranspositionTable::store(uint64_t key, int score, int depth, Bound bound,
+                               const PackedMove& bestMove)
+{
+    Bucket& bucket = bucketFor(key);
+    Slot* target = nullptr;
+    int targetWorth = 0;
+    bool sameKey = false;
+
+    for (Slot& slot : bucket.slots)
+    {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+
+        if (boundOf(data) != Bound::NONE && (check ^ data) == key)
+        {
+            // Same position: keep its move if we have none to offer
+            target = &slot;
+            sameKey = true;
+            if (bestMove.isNull() && !moveOf(data).isNull())
+            {
+                uint64_t packed = pack(score, depth, bound, moveOf(data), generation);
+                slot.data.store(packed, std::memory_order_relaxed);
+                slot.keyXorData.store(key ^ packed, std::memory_order_relaxed);
+                return false;
+            }
+            break;
+        }
+
+        // Empty slots are worth nothing; otherwise depth, minus a penalty for age
+        int age = static_cast<uint8_t>(generation - generationOf(data));
+        int worth = (boundOf(data) == Bound::NONE) ? -1000 : depthOf(data) - 8 * age;
+        if (target == nullptr || worth < targetWorth)
+        {
+            target = &slot;
+            targetWorth = worth;
+        }
+    }
+
+    bool evicted = !sameKey && boundOf(target->data.load(std::memory_order_relaxed)) != Bound::NONE;
+
+    uint64_t packed = pack(score, depth, bound, bestMove, generation);
+    target->data.store(packed, std::memory_order_relaxed);
+    target->keyXorData.store(key ^ packed, std::memory_order_relaxed);
+    return evicted;
+}
+
+// Permille of the first 1000 slots holding an entry from the current search
+int TranspositionTable::hashfull() const
+{
+    int used = 0;
+    int sampled = 0;
+    for (std::size_t b = 0; b < buckets.size() && sampled < 1000; b++)
+    {
+        for (const Slot& slot : buckets[b].slots)
+        {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (boundOf(data) != Bound::NONE && generationOf(data) == generation)
+            {
+                used++;
+            }
+            sampled++;
+        }
+    }
+    return sampled > 0 ? used * 1000 / sampled : 0;
+}
@@ -0,0 +1,83 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "MoveList.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How a stored score relates to the true value of the position
+enum class Bound : uint8_t
+{
+    NONE,
+    EXACT,  // Score is exact
+    LOWER,  // Search failed high: true score >= stored score
+    UPPER   // Search failed low: true score <= stored score
+};
+
+// What a probe hands back to the search
+struct TTEntry
+{
+    int score;
+    int depth;
+    Bound bound;
+    PackedMove bestMove;  // Null if none was stored
+
+    TTEntry() : score(0), depth(0), bound(Bound::NONE) {}
+};
+
+// Fixed-size hash table of searched positions, shared by every search thread.
+//
+// Each slot holds two 64-bit words: the packed data and (key XOR data).
+// Both are read and written with relaxed atomics and no lock. If two
+// threads race on a slot, a reader may see one thread's key word with the
+// other's data word; the XOR check then fails and the slot is treated as a
+// miss instead of returning a corrupted entry.
+//
+// Slots are grouped four to a 64-byte bucket so a probe touches one cache line.
+class TranspositionTable
+{
+public:
+    static const int BUCKET_SIZE = 4;
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket
+    {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    std::vector<Bucket> buckets;
+    uint8_t generation;  // Bumped per search so stale entries are replaced first
+
+    Bucket& bucketFor(uint64_t key) { return buckets[key & (buckets.size() - 1)]; }
+
+public:
+    // sizeMB is rounded down to a power-of-two number of buckets
+    explicit TranspositionTable(std::size_t sizeMB = 16);
+
+    void resize(std::size_t sizeMB);
+    void clear();
+
+    // Call at the start of each new search
+    void newSearch() { generation++; }
+
+    // Looks the key up; returns true and fills entry on a verified hit
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    // Stores a result; returns true if it evicted a different position
+    bool store(uint64_t key, int score, int depth, Bound bound, const PackedMove& bestMove);
+
+    // Permille of sampled slots written during the current search (UCI "hashfull")
+    int hashfull() const;
+
+    std::size_t sizeBytes() const { return buckets.size() * sizeof(Bucket); }
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -0,0 +1,322 @@
+#include "UciEngine.h"
+#include "BitboardBoard.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+UciEngine::UciEngine()
+    : sideToMove(Color::WHITE), table(16), search(table, 1), stopRequested(false)
+{
+    search.setIterationCallback([this](const SearchResult& result) { sendInfo(result); });
+}
+
+UciEngine::~UciEngine()
+{
+    stopSearch();
+}
+
+// Write one line and flush it
+void UciEngine::send(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+// Command loop
+int UciEngine::run(std::istream& in)
+{
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream tokens(line);
+        std::string command;
+        tokens >> command;
+
+        if (command == "uci")
+        {
+            handleUci();
+        }
+        else if (command == "isready")
+        {
+            send("readyok");
+        }
+        else if (command == "setoption")
+        {
+            handleSetOption(tokens);
+        }
+        else if (command == "ucinewgame")
+        {
+            stopSearch();
+            table.clear();
+        }
+        else if (command == "position")
+        {
+            handlePosition(tokens);
+        }
+        else if (command == "go")
+        {
+            handleGo(tokens);
+        }
+        else if (command == "stop")
+        {
+            stopSearch();
+        }
+        else if (command == "quit")
+        {
+            break;
+        }
+        else if (!command.empty())
+        {
+            send("info string unknown command " + command);
+        }
+    }
+
+    stopSearch();
+    return 0;
+}
+
+// Identify the engine and list its options
+void UciEngine::handleUci()
+{
+    send("id name Multi-Paradigm Chess Engine");
+    send("id author CS396 Final Project");
+    send("option name Hash type spin default 16 min 1 max 1024");
+    send("option name Threads type spin default 1 min 1 max 64");
+    send("uciok");
+}
+
+// "setoption name <id> value <x>"
+void UciEngine::handleSetOption(std::istringstream& in)
+{
+    std::string token;
+    std::string name;
+    std::string value;
+    in >> token;  // "name"
+    while (in >> token && token != "value")
+    {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    in >> value;
+
+    stopSearch();
+    if (name == "Hash")
+    {
+        table.resize(std::min(1024, std::max(1, std::atoi(value.c_str()))));
+    }
+    else if (name == "Threads")
+    {
+        search.setThreads(std::min(64, std::max(1, std::atoi(value.c_str()))));
+    }
+    else
+    {
+        send("info string unknown option " + name);
+    }
+}
+
+// "position startpos|fen <fen> [moves m1 m2 ...]"
+void UciEngine::handlePosition(std::istringstream& in)
+{
+    stopSearch();
+
+    std::string token;
+    std::string fen;
+    in >> token;
+    if (token == "fen")
+    {
+        while (in >> token && token != "moves")
+        {
+            fen += (fen.empty() ? "" : " ") + token;
+        }
+    }
+    else
+    {
+        fen = START_FEN;
+        in >> token;  // "moves", if present
+    }
+
+    if (!board.fromFEN(fen))
+    {
+        send("info string invalid fen " + fen);
+        board.setupInitialPosition();
+    }
+    sideToMove = board.sideToMove();
+    if (token != "moves")
+    {
+        return;
+    }
+
+    // Replay the moves, stopping at the first one that is not legal
+    while (in >> token)
+    {
+        Move move(-1, -1, -1, -1);
+        if (!parseMove(token, move) || !BitboardBoard(board).isLegalMove(sideToMove, move))
+        {
+            send("info string illegal move " + token);
+            return;
+        }
+        board.executeMove(move);
+        sideToMove = (sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    }
+}
+
+// "go [searchmoves M...] [ponder] [depth N] [movetime MS] [wtime MS] [btime MS]
+//     [winc MS] [binc MS] [infinite]"
+void UciEngine::handleGo(std::istringstream& in)
+{
+    stopSearch();
+
+    SearchLimits limits;
+    bool infinite = false;
+    std::string token;
+    bool haveToken = static_cast<bool>(in >> token);
+    while (haveToken)
+    {
+        if (token == "infinite")
+        {
+            infinite = true;
+        }
+        else if (token == "searchmoves")
+        {
+            // The moves run up to the next keyword or the end of the line
+            Move move(-1, -1, -1, -1);
+            while ((haveToken = static_cast<bool>(in >> token)) && parseMove(token, move))
+            {
+                limits.searchMoves.push_back(move);
+            }
+            continue;
+        }
+        else if (token != "ponder")  // No pondering: "go ponder" searches as usual
+        {
+            // Every other keyword takes a number. If none follows, the next
+            // word is treated as a keyword rather than dropping the rest.
+            std::string valueText;
+            if (!(in >> valueText))
+            {
+                break;
+            }
+            char* end = nullptr;
+            long parsed = std::strtol(valueText.c_str(), &end, 10);
+            if (end == valueText.c_str() || *end != '\0')
+            {
+                token = valueText;
+                continue;
+            }
+            int value = static_cast<int>(std::max(-1000000000L, std::min(1000000000L, parsed)));
+
+            if (token == "depth")          limits.depth = std::max(1, value);
+            else if (token == "movetime")  limits.moveTime = std::max(1, value);
+            else if (token == "wtime")     limits.whiteTime = std::max(1, value);
+            else if (token == "btime")     limits.blackTime = std::max(1, value);
+            else if (token == "winc")      limits.whiteInc = std::max(0, value);
+            else if (token == "binc")      limits.blackInc = std::max(0, value);
+            // movestogo, nodes and the rest are read and ignored
+        }
+        haveToken = static_cast<bool>(in >> token);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopRequested = false;
+    }
+    search.clearStop();
+
+    Board position = board;
+    Color color = sideToMove;
+    searchThread = std::thread([this, position, color, limits, infinite]()
+    {
+        SearchResult result = search.think(position, color, limits);
+
+        // In infinite mode the answer waits for "stop", even after a mate is found
+        if (infinite)
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            stopSignal.wait(lock, [this]() { return stopRequested; });
+        }
+
+        send("bestmove " + (result.bestMove.fromRow < 0 ? std::string("0000")
+                                                       : Board::moveToString(result.bestMove)));
+    });
+}
+
+// Stop the running search and wait for it to report
+void UciEngine::stopSearch()
+{
+    if (!searchThread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopRequested = true;
+    }
+    stopSignal.notify_all();
+    search.stop();
+    searchThread.join();
+}
+
+// "info depth D score cp S nodes N nps X time MS hashfull H pv ..."
+void UciEngine::sendInfo(const SearchResult& result)
+{
+    std::ostringstream out;
+    out << "info depth " << result.depth << " score ";
+
+    // Mate scores become "mate N" in moves, negative when we are being mated
+    int mateBound = Search::MATE_SCORE - Search::MAX_DEPTH;
+    if (result.score >= mateBound)
+    {
+        out << "mate " << (Search::MATE_SCORE - result.score + 1) / 2;
+    }
+    else if (result.score <= -mateBound)
+    {
+        out << "mate -" << (Search::MATE_SCORE + result.score) / 2;
+    }
+    else
+    {
+        out << "cp " << result.score;
+    }
+
+    uint64_t nps = result.seconds > 0 ? static_cast<uint64_t>(result.nodes / result.seconds) : 0;
+    out << " nodes " << result.nodes
+        << " nps " << nps
+        << " time " << static_cast<int>(result.seconds * 1000)
+        << " hashfull " << result.hashfull
+        << " pv";
+    for (const Move& m : result.pv)
+    {
+        out << " " << Board::moveToString(m);
+    }
+    send(out.str());
+}
+
+// Parse a coordinate move like "e2e4" or "e7e8q"
+bool UciEngine::parseMove(const std::string& text, Move& move)
+{
+    if (text.size() < 4)
+    {
+        return false;
+    }
+    int fromCol = text[0] - 'a';
+    int fromRow = text[1] - '1';
+    int toCol = text[2] - 'a';
+    int toRow = text[3] - '1';
+    if (fromCol < 0 || fromCol > 7 || fromRow < 0 || fromRow > 7 ||
+        toCol < 0 || toCol > 7 || toRow < 0 || toRow > 7)
+    {
+        return false;
+    }
+    PieceType promotion = PieceType::EMPTY;
+    if (text.size() > 4)
+    {
+        switch (text[4])
+        {
+            case 'n': promotion = PieceType::KNIGHT; break;
+            case 'b': promotion = PieceType::BISHOP; break;
+            case 'r': promotion = PieceType::ROOK;   break;
+            case 'q': promotion = PieceType::QUEEN;  break;
+            default: return false;
+        }
+    }
+    move = Move(fromRow, fromCol, toRow, toCol, promotion);
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef UCI_ENGINE_H
+#define UCI_ENGINE_H
+
+#include "Board.h"
+#include "ParallelSearch.h"
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Universal Chess Interface front end ("chess_game uci").
+// Reads commands from stdin and answers on stdout with no board display or
+// banners, so the engine can run under a GUI or match manager. Searches run
+// on a background thread so "stop" and "isready" are answered while thinking.
+class UciEngine
+{
+private:
+    Board board;
+    Color sideToMove;
+    TranspositionTable table;
+    ParallelSearch search;
+
+    std::thread searchThread;
+    std::mutex stateMutex;               // Guards stopRequested
+    std::condition_variable stopSignal;
+    bool stopRequested;                  // "stop" arrived for the running search
+    std::mutex outputMutex;              // One line at a time on stdout
+
+    // Write one line and flush it (the GUI reads line by line)
+    void send(const std::string& line);
+
+    // Command handlers
+    void handleUci();
+    void handleSetOption(std::istringstream& in);
+    void handlePosition(std::istringstream& in);
+    void handleGo(std::istringstream& in);
+
+    // Stop the running search (if any) and wait for its bestmove
+    void stopSearch();
+
+    // "info ..." line for one completed iteration
+    void sendInfo(const SearchResult& result);
+
+    // "e2e4" -> Move; false if the text is not a move on the board
+    static bool parseMove(const std::string& text, Move& move);
+
+public:
+    UciEngine();
+    ~UciEngine();
+
+    UciEngine(const UciEngine&) = delete;
+    UciEngine& operator=(const UciEngine&) = delete;
+
+    // Command loop; returns the process exit code after "quit" or end of input
+    int run(std::istream& in);
+};
+
+#endif // UCI_ENGINE_H
@@ -0,0 +1,83 @@
+#include "Zobrist.h"
+
+// All keys, generated once from a fixed seed so hashes are reproducible
+struct ZobristKeys
+{
+    uint64_t pieces[2][6][64];
+    uint64_t side;
+    uint64_t castling[16];
+    uint64_t enPassant[8];  // By file
+
+    ZobristKeys()
+    {
+        // splitmix64
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        auto next = [&state]()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+
+        for (int c = 0; c < 2; c++)
+            for (int t = 0; t < 6; t++)
+                for (int sq = 0; sq < 64; sq++)
+                    pieces[c][t][sq] = next();
+        side = next();
+
+        // Each right gets a key; a set of rights is the XOR of its members
+        uint64_t rights[4];
+        for (int i = 0; i < 4; i++)
+            rights[i] = next();
+        for (int mask = 0; mask < 16; mask++)
+        {
+            castling[mask] = 0;
+            for (int i = 0; i < 4; i++)
+                if (mask & (1 << i))
+                    castling[mask] ^= rights[i];
+        }
+        for (int file = 0; file < 8; file++)
+            enPassant[file] = next();
+    }
+};
+
+static const ZobristKeys& keys()
+{
+    static const ZobristKeys table;
+    return table;
+}
+
+// Key for a piece standing on a square
+uint64_t Zobrist::pieceKey(const Piece& piece, int row, int col)
+{
+    if (piece.isEmpty())
+    {
+        return 0;
+    }
+    int c = (piece.color == Color::WHITE) ? 0 : 1;
+    int t = static_cast<int>(piece.type) - 1;
+    return keys().pieces[c][t][row * 8 + col];
+}
+
+// XORed in when Black is to move
+uint64_t Zobrist::sideKey()
+{
+    return keys().side;
+}
+
+// Key for a set of castling rights
+uint64_t Zobrist::castlingKey(int rights)
+{
+    return keys().castling[rights & 15];
+}
+
+// Key for an en-passant target square (only its file matters)
+uint64_t Zobrist::enPassantKey(int square)
+{
+    if (square < 0)
+    {
+        return 0;
+    }
+    return keys().enPassant[square & 7];
+}
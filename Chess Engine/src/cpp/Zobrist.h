@@ -0,0 +1,26 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Board.h"
+#include <cstdint>
+
+// Random keys for Zobrist hashing. A position's key is the XOR of the keys
+// of every (piece, square) pair on it, plus its castling rights and
+// en-passant file, so a move updates it with a few XORs.
+class Zobrist
+{
+public:
+    // Key for a piece standing on a square (0 for an empty piece)
+    static uint64_t pieceKey(const Piece& piece, int row, int col);
+
+    // XORed in when Black is to move
+    static uint64_t sideKey();
+
+    // Key for a set of castling rights (Board::WHITE_KINGSIDE | ...); 0 for none
+    static uint64_t castlingKey(int rights);
+
+    // Key for an en-passant target square (0 for none, i.e. square < 0)
+    static uint64_t enPassantKey(int square);
+};
+
+#endif // ZOBRIST_H
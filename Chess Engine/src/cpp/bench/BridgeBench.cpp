@@ -0,0 +1,168 @@
+// BridgeBench.cpp
+// Bytes moved and parse time per Prolog bridge call, comparing the text
+// format (piece(...) board list, move(...) answers parsed with a fresh
+// stringstream per move) with the compact one (64-character board atom,
+// packed integer answers, single-pass parser).
+//
+// The answers are generated from the native move generator in the shape
+// swipl prints them, so this runs without Prolog. Given a prolog
+// directory it also runs getAllLegalMoves through swipl in both formats
+// and reports the bridge's own byte counters.
+//
+// Build (from src/cpp):
+//   g++ -std=c++17 -O2 -I. bench/BridgeBench.cpp Board.cpp Zobrist.cpp Evaluator.cpp Bitboard.cpp BitboardBoard.cpp BitboardMoveGenerator.cpp MoveGenerator.cpp PrologInterface.cpp -o bridge_bench
+// Run:
+//   ./bridge_bench [repeats] [prologPath]
+
+#include "Board.h"
+#include "BitboardMoveGenerator.h"
+#include "PrologInterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w - - 0 1",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w - - 0 8",
+    "3k4/8/8/8/8/8/8/3QK3 w - - 0 1",
+};
+
+// The parser getAllLegalMoves used before: a substr and a stringstream
+// for every "move(" in the answer
+static std::vector<Move> legacyParse(const std::string& result)
+{
+    std::vector<Move> moves;
+    std::vector<bool> seen(64 * 64, false);
+    std::size_t pos = 0;
+    while (true)
+    {
+        std::size_t start = result.find("move(", pos);
+        if (start == std::string::npos)
+            break;
+        start += 5;
+
+        int fr = 0, fc = 0, tr = 0, tc = 0;
+        char c1 = 0, c2 = 0, c3 = 0, closing = 0;
+        std::stringstream ss(result.substr(start));
+        ss >> fr >> c1 >> fc >> c2 >> tr >> c3 >> tc >> closing;
+
+        if (ss && c1 == ',' && c2 == ',' && c3 == ',' && closing == ')' &&
+            fr >= 1 && fr <= 8 && fc >= 1 && fc <= 8 &&
+            tr >= 1 && tr <= 8 && tc >= 1 && tc <= 8)
+        {
+            int key = ((fr - 1) * 8 + (fc - 1)) * 64 + (tr - 1) * 8 + (tc - 1);
+            if (!seen[key])
+            {
+                seen[key] = true;
+                moves.emplace_back(fr - 1, fc - 1, tr - 1, tc - 1);
+            }
+        }
+
+        pos = result.find(")", start);
+        if (pos == std::string::npos)
+            break;
+        ++pos;
+    }
+    return moves;
+}
+
+// Average nanoseconds per call of parse over repeats runs
+template <typename Parse>
+static double timePerCall(int repeats, Parse parse)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++)
+    {
+        parse();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / repeats;
+}
+
+int main(int argc, char* argv[])
+{
+    int repeats = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 20000;
+    std::string prologPath = (argc > 2) ? argv[2] : "";
+
+    BitboardMoveGenerator rules;
+    for (const char* fen : POSITIONS)
+    {
+        Board board;
+        board.fromFEN(fen);
+        std::vector<Move> legal = rules.getAllLegalMoves(board, board.sideToMove());
+
+        // What swipl prints for write(Moves) and for write_packed_moves(Moves)
+        std::ostringstream text;
+        std::ostringstream packed;
+        text << "[";
+        packed << "moves:";
+        for (std::size_t i = 0; i < legal.size(); i++)
+        {
+            const Move& m = legal[i];
+            text << (i ? "," : "") << "move(" << m.fromRow + 1 << "," << m.fromCol + 1 << ","
+                 << m.toRow + 1 << "," << m.toCol + 1 << ")";
+            packed << " " << (m.fromRow * 8 + m.fromCol) * 64 + m.toRow * 8 + m.toCol;
+        }
+        text << "]\n";
+        packed << "\n";
+        std::string textAnswer = text.str();
+        std::string packedAnswer = packed.str();
+
+        // Both parsers must agree with the old one
+        MoveList fromText;
+        MoveList fromPacked;
+        PrologInterface::parseMoveTerms(textAnswer, fromText);
+        PrologInterface::parsePackedMoves(packedAnswer, fromPacked);
+        std::size_t expected = legacyParse(textAnswer).size();
+        bool agree = fromText.size() == static_cast<int>(expected) &&
+                     fromPacked.size() == static_cast<int>(expected);
+
+        double legacyNs = timePerCall(repeats, [&]() { return legacyParse(textAnswer).size(); });
+        double textNs = timePerCall(repeats, [&]() { return PrologInterface::parseMoveTerms(textAnswer, fromText); });
+        double packedNs = timePerCall(repeats, [&]() { return PrologInterface::parsePackedMoves(packedAnswer, fromPacked); });
+
+        std::cout << fen << "\n"
+                  << "  " << legal.size() << " moves" << (agree ? "" : "  PARSERS DISAGREE") << "\n"
+                  << "  board sent:    text " << board.toPrologFormat().size() + 8
+                  << " bytes, compact " << board.toCompactString().size() + 21 << " bytes\n"
+                  << "  answer:        text " << textAnswer.size()
+                  << " bytes, compact " << packedAnswer.size() << " bytes\n"
+                  << "  parse:         old " << legacyNs << " ns, text " << textNs
+                  << " ns, compact " << packedNs << " ns\n";
+    }
+
+    if (prologPath.empty())
+    {
+        return 0;
+    }
+
+    // End to end through swipl, counting what actually crossed the pipes
+    for (BridgeFormat format : { BridgeFormat::TEXT, BridgeFormat::COMPACT })
+    {
+        PrologInterface prolog(prologPath, true, format);
+        uint64_t sentBefore = prolog.sentBytes();
+        uint64_t receivedBefore = prolog.receivedBytes();
+        uint64_t queriesBefore = prolog.queryCount();
+        std::size_t moves = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const char* fen : POSITIONS)
+        {
+            Board board;
+            board.fromFEN(fen);
+            moves += prolog.getAllLegalMoves(board, board.sideToMove()).size();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        uint64_t queries = prolog.queryCount() - queriesBefore;
+        std::cout << (format == BridgeFormat::TEXT ? "swipl, text:    " : "swipl, compact: ")
+                  << moves << " moves, "
+                  << (prolog.sentBytes() - sentBefore) / queries << " bytes sent and "
+                  << (prolog.receivedBytes() - receivedBefore) / queries << " received per query, "
+                  << ms / queries << " ms per query\n";
+    }
+    return 0;
+}
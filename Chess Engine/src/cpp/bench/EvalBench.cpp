@@ -0,0 +1,90 @@
+// EvalBench.cpp
+// Evaluations per second: reading the running totals Board keeps through
+// makeMove/unmakeMove (Evaluator::score) against summing every piece from
+// scratch (Evaluator::evaluate). Every leaf is also checked for agreement.
+//
+// Build (from src/cpp):
+//   g++ -std=c++17 -O2 -I. bench/EvalBench.cpp Board.cpp Zobrist.cpp Evaluator.cpp Bitboard.cpp BitboardBoard.cpp -o eval_bench
+// Run:
+//   ./eval_bench [depth] [repeats]
+
+#include "BitboardBoard.h"
+#include "Evaluator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+static Color other(Color c) { return c == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+// Walk the tree with make/unmake and keep a copy of every leaf. Returns
+// the number of leaves where the running score differs from a recount.
+static uint64_t collectLeaves(Board& board, Color color, int depth, std::vector<Board>& leaves)
+{
+    if (depth == 0)
+    {
+        leaves.push_back(board);
+        return board.evaluation().score() != Evaluator::evaluate(board) ? 1 : 0;
+    }
+
+    MoveList moves;
+    BitboardBoard(board).generateLegalMoves(color, moves);
+    uint64_t mismatches = 0;
+    for (const PackedMove& packed : moves)
+    {
+        Move m = packed.toMove();
+        UndoInfo undo = board.makeMove(m);
+        mismatches += collectLeaves(board, other(color), depth - 1, leaves);
+        board.unmakeMove(m, undo);
+    }
+    return mismatches;
+}
+
+template <typename Eval>
+static void report(const char* label, const std::vector<Board>& leaves, int repeats, Eval eval)
+{
+    long long sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (const Board& board : leaves)
+        {
+            sink += eval(board);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double evals = static_cast<double>(leaves.size()) * repeats;
+
+    std::cout << label << ": " << (seconds > 0 ? evals / seconds : 0.0) << " evals/s ("
+              << seconds * 1000.0 << " ms, checksum " << sink << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int depth = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 3;
+    int repeats = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 20;
+    Attacks::init();
+
+    std::vector<Board> leaves;
+    uint64_t mismatches = 0;
+    for (const char* fen : POSITIONS)
+    {
+        Board board;
+        board.fromFEN(fen);
+        mismatches += collectLeaves(board, board.sideToMove(), depth, leaves);
+    }
+    std::cout << leaves.size() << " leaf positions, " << mismatches << " incremental/full mismatches\n";
+
+    report("Incremental (Evaluator::score)   ", leaves, repeats,
+           [](const Board& board) { return board.evaluation().score(); });
+    report("Full recount (Evaluator::evaluate)", leaves, repeats,
+           [](const Board& board) { return Evaluator::evaluate(board); });
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// MakeMoveBench.cpp
+// Latency of the Prolog round-trips behind Game::makeMove, comparing one
+// swipl process per query with the persistent query_server.pl session.
+//
+// Build (from src/cpp):
+//   g++ -std=c++17 -O2 -I. bench/MakeMoveBench.cpp Board.cpp Zobrist.cpp Evaluator.cpp Bitboard.cpp BitboardBoard.cpp BitboardMoveGenerator.cpp MoveGenerator.cpp PrologInterface.cpp -o makemove_bench
+// Run:
+//   ./makemove_bench [prologPath] [iterations]
+
+#include "Board.h"
+#include "PrologInterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Replays what Game::makeMove asks Prolog for e2e4 from the starting
+// position: legality, then checkmate and check for the opponent.
+static double timeMakeMove(const PrologInterface& prolog)
+{
+    Board board;
+    Move move(1, 4, 3, 4);
+
+    auto start = std::chrono::steady_clock::now();
+    if (prolog.isLegalMove(board, Color::WHITE, move))
+    {
+        board.executeMove(move);
+        prolog.isCheckmate(board, Color::BLACK);
+        prolog.isInCheck(board, Color::BLACK);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Runs the move several times and prints mean and median latency
+static void report(const std::string& label, const PrologInterface& prolog, int iterations)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; i++)
+    {
+        samples.push_back(timeMakeMove(prolog));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double s : samples)
+    {
+        total += s;
+    }
+
+    std::cout << label << ": mean " << (total / iterations) << " ms, median "
+              << samples[samples.size() / 2] << " ms over "
+              << iterations << " makeMove calls\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::string prologPath = (argc > 1) ? argv[1] : "../prolog";
+    int iterations = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 10;
+
+    // Before: a fresh swipl process for each of the three queries
+    PrologInterface oneShot(prologPath, false);
+    report("one process per query", oneShot, iterations);
+
+    // After: rules consulted once, queries sent over the session pipes
+    auto start = std::chrono::steady_clock::now();
+    PrologInterface session(prologPath, true);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "session startup: "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << (session.hasSession() ? "" : " (session unavailable)") << "\n";
+    report("persistent session", session, iterations);
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+// MoveListBench.cpp
+// Counts heap allocations made by move generation, comparing the old
+// path (std::vector<Move> per call, plus the "e2e4" strings getAIMove
+// used to build) with PackedMove + MoveList on the stack.
+//
+// Build (from src/cpp):
+//   g++ -std=c++17 -O2 -I. bench/MoveListBench.cpp Board.cpp Zobrist.cpp Evaluator.cpp Bitboard.cpp BitboardBoard.cpp BitboardMoveGenerator.cpp MoveGenerator.cpp PrologInterface.cpp -o movelist_bench
+// Run:
+//   ./movelist_bench [depth]
+
+#include "BitboardBoard.h"
+#include "BitboardMoveGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Every global allocation goes through here
+static uint64_t allocationCount = 0;
+
+void* operator new(std::size_t size)
+{
+    allocationCount++;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static Color other(Color c) { return c == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+// Before: the MoveGenerator API returns a vector, and each move became a string
+static uint64_t walkVector(const BitboardMoveGenerator& generator, Board& board, Color color, int depth)
+{
+    std::vector<Move> moves = generator.getAllLegalMoves(board, color);
+    std::vector<std::string> strings;
+    strings.reserve(moves.size());
+    for (const Move& m : moves)
+    {
+        strings.push_back(Board::moveToString(m));
+    }
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    uint64_t nodes = 0;
+    for (const Move& m : moves)
+    {
+        Piece moved = board.getPiece(m.fromRow, m.fromCol);
+        Piece captured = board.getPiece(m.toRow, m.toCol);
+        board.executeMove(m);
+        nodes += walkVector(generator, board, other(color), depth - 1);
+        board.setPiece(m.fromRow, m.fromCol, moved);
+        board.setPiece(m.toRow, m.toCol, captured);
+    }
+    return nodes;
+}
+
+// After: PackedMove in a stack MoveList
+static uint64_t walkMoveList(Board& board, Color color, int depth)
+{
+    MoveList moves;
+    BitboardBoard(board).generateLegalMoves(color, moves);
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    uint64_t nodes = 0;
+    for (const PackedMove& packed : moves)
+    {
+        Move m = packed.toMove();
+        Piece moved = board.getPiece(m.fromRow, m.fromCol);
+        Piece captured = board.getPiece(m.toRow, m.toCol);
+        board.executeMove(m);
+        nodes += walkMoveList(board, other(color), depth - 1);
+        board.setPiece(m.fromRow, m.fromCol, moved);
+        board.setPiece(m.toRow, m.toCol, captured);
+    }
+    return nodes;
+}
+
+template <typename Walk>
+static void report(const char* label, Walk walk)
+{
+    uint64_t before = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = walk();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocations = allocationCount - before;
+
+    std::cout << label << ": " << nodes << " leaves, " << allocations << " allocations ("
+              << (nodes ? static_cast<double>(allocations) / nodes : 0.0) << " per leaf), "
+              << seconds * 1000.0 << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int depth = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 4;
+    BitboardMoveGenerator generator;
+
+    report("std::vector<Move> + strings", [&]()
+    {
+        Board board;
+        return walkVector(generator, board, Color::WHITE, depth);
+    });
+    report("PackedMove + MoveList      ", [&]()
+    {
+        Board board;
+        return walkMoveList(board, Color::WHITE, depth);
+    });
+
+    std::cout << "sizeof(Move) = " << sizeof(Move) << ", sizeof(PackedMove) = "
+              << sizeof(PackedMove) << ", sizeof(MoveList) = " << sizeof(MoveList) << "\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+// SchemeBench.cpp
+// Latency of N consecutive SchemeInterface::chooseMove calls, comparing one
+// racket process per move with the resident "ai.rkt --server".
+//
+// Build (from src/cpp):
+//   g++ -std=c++17 -O2 -I. bench/SchemeBench.cpp Board.cpp Zobrist.cpp Evaluator.cpp Bitboard.cpp BitboardBoard.cpp BitboardMoveGenerator.cpp MoveGenerator.cpp PrologInterface.cpp SchemeInterface.cpp Instrumentation.cpp -o scheme_bench
+// Run:
+//   ./scheme_bench [schemePath] [calls] [movetimeMs]
+
+#include "Board.h"
+#include "BitboardMoveGenerator.h"
+#include "Instrumentation.h"
+#include "SchemeInterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Plays calls plies from the starting position, letting Scheme pick every
+// move, and times each chooseMove. Both modes see the same positions as
+// long as ai.rkt answers the same way.
+static void report(const std::string& label, const SchemeInterface& scheme, int calls, int moveTime)
+{
+    BitboardMoveGenerator rules;
+    Board board;
+    Color color = Color::WHITE;
+    LatencyHistogram latency;
+    double first = 0.0;
+
+    for (int i = 0; i < calls; i++)
+    {
+        std::vector<Move> legal = rules.getAllLegalMoves(board, color);
+        if (legal.empty())
+        {
+            board = Board();
+            color = Color::WHITE;
+            legal = rules.getAllLegalMoves(board, color);
+        }
+        std::vector<std::string> moveStrings;
+        for (const Move& m : legal)
+        {
+            moveStrings.push_back(Board::moveToString(m));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::string chosen = scheme.chooseMove(Board::colorToString(color), board.toSchemeString(),
+                                               moveStrings, moveTime);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0)
+        {
+            first = ms;
+        }
+        latency.add(ms);
+
+        // Fall back to the first legal move if Scheme gave nothing usable
+        Move played = legal.front();
+        for (const Move& m : legal)
+        {
+            if (Board::moveToString(m) == chosen)
+            {
+                played = m;
+            }
+        }
+        board.makeMove(played);
+        color = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    }
+
+    std::cout << label << ": first call " << first << " ms\n" << latency.summary();
+}
+
+int main(int argc, char* argv[])
+{
+    std::string schemePath = (argc > 1) ? argv[1] : "../scheme";
+    int calls = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 20;
+    int moveTime = (argc > 3) ? std::max(0, std::atoi(argv[3])) : 0;
+
+    // Before: racket started, and ai.rkt loaded, for every move
+    SchemeInterface oneShot(schemePath, false);
+    report("one process per move", oneShot, calls, moveTime);
+
+    // After: the first call starts the server, the rest reuse it
+    SchemeInterface server(schemePath, true);
+    report("resident server", server, calls, moveTime);
+    std::cout << "server " << (server.hasServer() ? "running" : "unavailable")
+              << ", restarts " << server.restartCount() << "\n";
+
+    return 0;
+}
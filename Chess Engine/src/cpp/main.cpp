@@ -1,11 +1,134 @@
+#include "Analyze.h"
 #include "Game.h"
+#include "Perft.h"
+#include "SelfPlay.h"
+#include "UciEngine.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
 
-int main() 
+int main(int argc, char* argv[]) 
 {
+    // Subcommands: chess_game perft ... / analyze ... / selfplay ... / uci
+    if (argc > 1 && std::string(argv[1]) == "perft") 
+    {
+        std::vector<std::string> args(argv + 2, argv + argc);
+        return runPerftCommand(args, "../prolog");
+    }
+    
+    if (argc > 1 && std::string(argv[1]) == "analyze") 
+    {
+        std::vector<std::string> args(argv + 2, argv + argc);
+        return runAnalyzeCommand(args);
+    }
+    
+    if (argc > 1 && std::string(argv[1]) == "selfplay") 
+    {
+        std::vector<std::string> args(argv + 2, argv + argc);
+        return runSelfPlayCommand(args, "../prolog", "../scheme");
+    }
+    
+    // chess_game uci: headless UCI engine on stdin/stdout
+    if (argc > 1 && std::string(argv[1]) == "uci") 
+    {
+        UciEngine engine;
+        return engine.run(std::cin);
+    }
+    
+    GameOptions options;
+    bool depthGiven = false;
+    for (int i = 1; i < argc; i++) 
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        if (arg == "--backend" && hasValue) 
+        {
+            // Rules backend: the native bitboard generator unless told otherwise
+            if (!parseMoveBackend(argv[++i], options.rulesBackend)) 
+            {
+                std::cerr << "Unknown backend '" << argv[i] << "' (use bitboard or prolog)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--ai" && hasValue) 
+        {
+            std::string ai = argv[++i];
+            if (ai == "native") 
+            {
+                options.aiBackend = AiBackend::NATIVE;
+            }
+            else if (ai == "scheme") 
+            {
+                options.aiBackend = AiBackend::SCHEME;
+            }
+            else 
+            {
+                std::cerr << "Unknown AI '" << ai << "' (use native or scheme)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--depth" && hasValue) 
+        {
+            options.limits.depth = std::max(1, std::atoi(argv[++i]));
+            depthGiven = true;
+        }
+        else if (arg == "--movetime" && hasValue) 
+        {
+            options.limits.moveTime = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--wtime" && hasValue) 
+        {
+            options.limits.whiteTime = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--btime" && hasValue) 
+        {
+            options.limits.blackTime = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--winc" && hasValue) 
+        {
+            options.limits.whiteInc = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--binc" && hasValue) 
+        {
+            options.limits.blackInc = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--threads" && hasValue) 
+        {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--hash" && hasValue) 
+        {
+            options.hashMB = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--stats" && hasValue) 
+        {
+            options.statsPath = argv[++i];
+        }
+        else 
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--backend bitboard|prolog] [--ai native|scheme] [--hash MB] [--threads N] [--stats FILE]\n"
+                      << "       [--depth N] [--movetime MS] [--wtime MS] [--btime MS] [--winc MS] [--binc MS]\n"
+                      << "       " << argv[0] << " perft ...\n"
+                      << "       " << argv[0] << " analyze --input FILE ...\n"
+                      << "       " << argv[0] << " selfplay ...\n"
+                      << "       " << argv[0] << " uci\n";
+            return 1;
+        }
+    }
+    
+    // With a time budget the depth is only a cap if it was asked for
+    if (options.limits.isTimed() && !depthGiven) 
+    {
+        options.limits.depth = 0;
+    }
+    
     try 
     {
-        Game game("../prolog", "../scheme");
+        Game game("../prolog", "../scheme", options);
         game.play();
     }
     catch (const std::exception& e) 
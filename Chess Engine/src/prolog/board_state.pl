@@ -1,13 +1,18 @@
 % board_state.pl
 % Basic board representation
 
-% Represents a piece: piece(Type, Color, Row, Col)
+% The board is a board/64 term. Argument (Row - 1) * 8 + Col holds
+% piece(Type, Color) for an occupied square and the atom empty otherwise,
+% so looking at a square is one arg/3 call rather than a scan.
 % Type: pawn, rook, knight, bishop, queen, king
 % Color: white, black
 % Row/Col: 1-8
+%
+% Outside the rules a piece is still written piece(Type, Color, Row, Col),
+% and the public predicates also accept a list of those (board_term/2).
 
-% Initial board setup
-initial_board([
+% Initial position as a piece list
+initial_pieces([
     % White pieces
     piece(rook,  white, 1, 1), piece(knight, white, 1, 2),
     piece(bishop,white, 1, 3), piece(queen,  white, 1, 4),
@@ -29,25 +34,132 @@ initial_board([
     piece(pawn,  black, 7, 7), piece(pawn,   black, 7, 8)
 ]).
 
+% Initial board setup
+initial_board(Board) :-
+    initial_pieces(Pieces),
+    pieces_board(Pieces, Board).
+
+% ======================
+% BOARD TERM
+% ======================
+
+% Build a board term from a list of piece(Type, Color, Row, Col)
+pieces_board(Pieces, Board) :-
+    functor(Board, board, 64),
+    place_pieces(Pieces, Board),
+    fill_empty(Board, 1).
+
+place_pieces([], _).
+place_pieces([piece(Type, Color, Row, Col)|Rest], Board) :-
+    square_index(Row, Col, Index),
+    arg(Index, Board, piece(Type, Color)),
+    place_pieces(Rest, Board).
+
+% Mark every square no piece was placed on as empty
+fill_empty(_, 65) :- !.
+fill_empty(Board, Index) :-
+    arg(Index, Board, Contents),
+    ( var(Contents) -> Contents = empty ; true ),
+    Next is Index + 1,
+    fill_empty(Board, Next).
+
+% Accept either representation: a board term is used as it is, a piece
+% list is converted once
+board_term(Board, Board) :-
+    compound(Board),
+    compound_name_arity(Board, board, 64),
+    !.
+board_term(Pieces, Board) :-
+    is_list(Pieces),
+    pieces_board(Pieces, Board).
+
+% Argument index of a square
+square_index(Row, Col, Index) :-
+    Index is (Row - 1) * 8 + Col.
+
+% Contents of a square on the board: piece(Type, Color) or empty
+square(Board, Row, Col, Contents) :-
+    Index is (Row - 1) * 8 + Col,
+    arg(Index, Board, Contents).
+
 % Check if a square is on the board
 on_board(Row, Col) :-
     Row >= 1, Row =< 8,
     Col >= 1, Col =< 8.
 
-% Find a piece at a specific position
+% Find a piece at a specific position. With the square left unbound,
+% enumerate the pieces on the board instead.
 piece_at(Board, Row, Col, piece(Type, Color, Row, Col)) :-
-    member(piece(Type, Color, Row, Col), Board).
+    (   integer(Row), integer(Col)
+    ->  on_board(Row, Col),
+        square(Board, Row, Col, piece(Type, Color))
+    ;   arg(Index, Board, piece(Type, Color)),
+        Row is (Index - 1) // 8 + 1,
+        Col is (Index - 1) mod 8 + 1
+    ).
 
 % Check if a square is empty
 is_empty(Board, Row, Col) :-
     on_board(Row, Col),
-    \+ member(piece(_, _, Row, Col), Board).
+    square(Board, Row, Col, empty).
 
 % Check if a square contains an opponents piece
 is_opponent(Board, Row, Col, Color) :-
-    piece_at(Board, Row, Col, piece(_, OpponentColor, Row, Col)),
+    on_board(Row, Col),
+    square(Board, Row, Col, piece(_, OpponentColor)),
     opposite_color(Color, OpponentColor).
 
 % Define opposite colors
 opposite_color(white, black).
 opposite_color(black, white).
+
+% ======================
+% WIRE FORMAT
+% ======================
+
+% The C++ side sends a board as one 64-character atom, square a1 first and
+% h8 last, holding FEN letters (uppercase white) and '.' for empty squares.
+% Character N of the atom is argument N of the board term.
+wire_board(Atom, Board) :-
+    atom_codes(Atom, Codes),
+    functor(Board, board, 64),
+    wire_squares(Codes, 1, Board).
+
+wire_squares([], _, _).
+wire_squares([Code|Rest], Index, Board) :-
+    wire_square(Code, Contents),
+    arg(Index, Board, Contents),
+    Next is Index + 1,
+    wire_squares(Rest, Next, Board).
+
+wire_square(Code, empty) :-
+    char_code('.', Code),
+    !.
+wire_square(Code, piece(Type, Color)) :-
+    wire_piece(Code, Type, Color).
+
+wire_piece(0'P, pawn,   white).
+wire_piece(0'N, knight, white).
+wire_piece(0'B, bishop, white).
+wire_piece(0'R, rook,   white).
+wire_piece(0'Q, queen,  white).
+wire_piece(0'K, king,   white).
+wire_piece(0'p, pawn,   black).
+wire_piece(0'n, knight, black).
+wire_piece(0'b, bishop, black).
+wire_piece(0'r, rook,   black).
+wire_piece(0'q, queen,  black).
+wire_piece(0'k, king,   black).
+
+% Print a move list as "moves:" and then one integer From * 64 + To per
+% move, where a square is (Row - 1) * 8 + (Col - 1), instead of move(...)
+% terms. The prefix lets the reader skip anything printed before it.
+write_packed_moves(Moves) :-
+    write('moves:'),
+    write_packed_codes(Moves).
+
+write_packed_codes([]).
+write_packed_codes([move(FromRow, FromCol, ToRow, ToCol)|Rest]) :-
+    Code is ((FromRow - 1) * 8 + FromCol - 1) * 64 + (ToRow - 1) * 8 + ToCol - 1,
+    write(' '), write(Code),
+    write_packed_codes(Rest).
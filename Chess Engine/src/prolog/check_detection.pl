@@ -1,5 +1,5 @@
 % check_detection.pl
-% Detects check, checkmate, and stalemate 
+% Detects check, checkmate, and stalemate
 
 :- [board_state].
 :- [piece_moves].
@@ -10,39 +10,254 @@
 % ======================
 
 find_king(Board, Color, Row, Col) :-
-    member(piece(king, Color, Row, Col), Board).
+    piece_at(Board, Row, Col, piece(king, Color, Row, Col)).
+
+% ======================
+% ATTACKS
+% ======================
+
+% The piece of color By at (FromRow, FromCol) that attacks (Row, Col)
+% along a line or with a pawn or knight, found by looking outward from
+% the attacked square. Between lists the squares a check from it could
+% be blocked on.
+attacker(Board, Row, Col, By, FromRow, FromCol, []) :-
+    (By = white -> FromRow is Row - 1 ; FromRow is Row + 1),
+    (FromCol is Col - 1 ; FromCol is Col + 1),
+    occupied_by(Board, FromRow, FromCol, pawn, By).
+attacker(Board, Row, Col, By, FromRow, FromCol, []) :-
+    knight_offset(RowStep, ColStep),
+    FromRow is Row + RowStep,
+    FromCol is Col + ColStep,
+    occupied_by(Board, FromRow, FromCol, knight, By).
+attacker(Board, Row, Col, By, FromRow, FromCol, Between) :-
+    line_direction(RowDir, ColDir, Line),
+    first_piece(Board, Row, Col, RowDir, ColDir, FromRow, FromCol, piece(Type, By)),
+    slides_along(Type, Line),
+    squares_between(Row, Col, RowDir, ColDir, FromRow, FromCol, Between).
+
+% Square (Row, Col) is attacked by any piece of color By
+square_attacked(Board, Row, Col, By) :-
+    attacker(Board, Row, Col, By, _, _, _),
+    !.
+square_attacked(Board, Row, Col, By) :-
+    king_offset(RowStep, ColStep),
+    KingRow is Row + RowStep,
+    KingCol is Col + ColStep,
+    occupied_by(Board, KingRow, KingCol, king, By),
+    !.
+
+occupied_by(Board, Row, Col, Type, Color) :-
+    on_board(Row, Col),
+    square(Board, Row, Col, piece(Type, Color)).
+
+% Position and contents of the first piece along a ray, not counting
+% the starting square
+first_piece(Board, Row, Col, RowDir, ColDir, PieceRow, PieceCol, Piece) :-
+    NextRow is Row + RowDir,
+    NextCol is Col + ColDir,
+    on_board(NextRow, NextCol),
+    square(Board, NextRow, NextCol, Contents),
+    (   Contents == empty
+    ->  first_piece(Board, NextRow, NextCol, RowDir, ColDir, PieceRow, PieceCol, Piece)
+    ;   PieceRow = NextRow,
+        PieceCol = NextCol,
+        Piece = Contents
+    ).
+
+% Squares strictly between (Row, Col) and (ToRow, ToCol) along a ray
+squares_between(Row, Col, RowDir, ColDir, ToRow, ToCol, Squares) :-
+    NextRow is Row + RowDir,
+    NextCol is Col + ColDir,
+    (   NextRow =:= ToRow, NextCol =:= ToCol
+    ->  Squares = []
+    ;   Squares = [NextRow-NextCol|Rest],
+        squares_between(NextRow, NextCol, RowDir, ColDir, ToRow, ToCol, Rest)
+    ).
+
+line_direction(RowDir, ColDir, straight) :- rook_direction(RowDir, ColDir).
+line_direction(RowDir, ColDir, diagonal) :- bishop_direction(RowDir, ColDir).
+
+slides_along(queen, _).
+slides_along(rook, straight).
+slides_along(bishop, diagonal).
+
+% Squares a piece attacks, whether or not it could move there
+piece_attack(_, pawn, Color, FromRow, FromCol, Row, Col) :-
+    (Color = white -> Row is FromRow + 1 ; Row is FromRow - 1),
+    (Col is FromCol - 1 ; Col is FromCol + 1),
+    on_board(Row, Col).
+piece_attack(_, knight, _, FromRow, FromCol, Row, Col) :-
+    knight_offset(RowStep, ColStep),
+    Row is FromRow + RowStep,
+    Col is FromCol + ColStep,
+    on_board(Row, Col).
+piece_attack(_, king, _, FromRow, FromCol, Row, Col) :-
+    king_offset(RowStep, ColStep),
+    Row is FromRow + RowStep,
+    Col is FromCol + ColStep,
+    on_board(Row, Col).
+piece_attack(Board, Type, _, FromRow, FromCol, Row, Col) :-
+    slides_along(Type, Line),
+    line_direction(RowDir, ColDir, Line),
+    ray_square(Board, FromRow, FromCol, RowDir, ColDir, Row, Col).
+
+% Squares along a ray up to and including the first piece
+ray_square(Board, Row, Col, RowDir, ColDir, ToRow, ToCol) :-
+    NextRow is Row + RowDir,
+    NextCol is Col + ColDir,
+    on_board(NextRow, NextCol),
+    (   ToRow = NextRow,
+        ToCol = NextCol
+    ;   square(Board, NextRow, NextCol, empty),
+        ray_square(Board, NextRow, NextCol, RowDir, ColDir, ToRow, ToCol)
+    ).
+
+% Every square attacked by color By, as an attacks/64 term whose
+% arguments are attacked or safe
+attack_map(Board, By, Map) :-
+    findall(
+        Index,
+        (
+            piece_at(Board, FromRow, FromCol, piece(Type, By, FromRow, FromCol)),
+            piece_attack(Board, Type, By, FromRow, FromCol, Row, Col),
+            square_index(Row, Col, Index)
+        ),
+        Indices
+    ),
+    functor(Map, attacks, 64),
+    mark_attacked(Indices, Map),
+    fill_safe(Map, 1).
+
+mark_attacked([], _).
+mark_attacked([Index|Rest], Map) :-
+    arg(Index, Map, attacked),
+    mark_attacked(Rest, Map).
+
+fill_safe(_, 65) :- !.
+fill_safe(Map, Index) :-
+    arg(Index, Map, Mark),
+    ( var(Mark) -> Mark = safe ; true ),
+    Next is Index + 1,
+    fill_safe(Map, Next).
+
+% ======================
+% PINS & CHECK EVASIONS
+% ======================
+
+% Own pieces that shield the king from an enemy slider, as
+% pin(Row, Col, RowDir, ColDir) with the direction from the king
+pinned_pieces(Board, Color, KingRow, KingCol, Pins) :-
+    opposite_color(Color, OpponentColor),
+    findall(
+        pin(Row, Col, RowDir, ColDir),
+        (
+            line_direction(RowDir, ColDir, Line),
+            first_piece(Board, KingRow, KingCol, RowDir, ColDir, Row, Col, piece(_, Color)),
+            first_piece(Board, Row, Col, RowDir, ColDir, _, _, piece(Type, OpponentColor)),
+            slides_along(Type, Line)
+        ),
+        Pins
+    ).
+
+% What a move other than the king's must do about check: anything when
+% not in check, capture or block a single checker, nothing in double check
+evasion([], any).
+evasion([checker(Row, Col, Between)], squares([Row-Col|Between])).
+evasion([_, _|_], king_only).
+
+% Everything move legality depends on, worked out once per position:
+% the squares the opponent attacks with the king taken off the board
+% (so it cannot step back along a checking line), the pins and the
+% evasion rule
+legality(Board, Color, Legality) :-
+    (   find_king(Board, Color, KingRow, KingCol)
+    ->  opposite_color(Color, OpponentColor),
+        duplicate_term(Board, WithoutKing),
+        square_index(KingRow, KingCol, KingIndex),
+        setarg(KingIndex, WithoutKing, empty),
+        attack_map(WithoutKing, OpponentColor, Attacked),
+        pinned_pieces(Board, Color, KingRow, KingCol, Pins),
+        findall(
+            checker(Row, Col, Between),
+            attacker(Board, KingRow, KingCol, OpponentColor, Row, Col, Between),
+            Checkers
+        ),
+        evasion(Checkers, Evasion),
+        Legality = legality(KingRow, KingCol, Attacked, Pins, Evasion)
+    ;   % Without a king nothing can be left in check
+        Legality = no_king
+    ).
+
+% Whether a pseudo-legal move keeps the king safe
+allowed(no_king, _, _, _, _, _).
+allowed(legality(_, _, Attacked, _, _), king, _, _, ToRow, ToCol) :-
+    !,
+    square_index(ToRow, ToCol, Index),
+    arg(Index, Attacked, safe).
+allowed(legality(KingRow, KingCol, _, Pins, Evasion), _, FromRow, FromCol, ToRow, ToCol) :-
+    evasion_allows(Evasion, ToRow, ToCol),
+    (   memberchk(pin(FromRow, FromCol, RowDir, ColDir), Pins)
+    ->  % A pinned piece may only move along the line through its king
+        (ToRow - KingRow) * ColDir =:= (ToCol - KingCol) * RowDir
+    ;   true
+    ).
+
+evasion_allows(any, _, _).
+evasion_allows(squares(Squares), Row, Col) :-
+    memberchk(Row-Col, Squares).
 
 % ======================
 % CHECK DETECTION
 % ======================
 
-% A king is in check if any opponent piece can attack it
-in_check(Board, Color) :-
+% A king is in check if any opponent piece attacks its square. Answers
+% are tabled per position, so asking again about a board already
+% settled in this game (is_checkmate and then in_check on the same move)
+% is a table lookup. new_game/0 empties the table, which otherwise would
+% grow for as long as the session runs.
+in_check(Board0, Color) :-
+    board_term(Board0, Board),
+    position_in_check(Board, Color).
+
+:- table position_in_check/2.
+
+position_in_check(Board, Color) :-
+    king_attacked(Board, Color).
+
+% Start a new game: forget the check answers tabled for earlier ones
+new_game :-
+    abolish_all_tables.
+
+% The untabled test, for the many boards move generation looks at once
+king_attacked(Board, Color) :-
     find_king(Board, Color, KingRow, KingCol),
     opposite_color(Color, OpponentColor),
-    member(piece(_, OpponentColor, FromRow, FromCol), Board),
-    valid_move(Board, OpponentColor, FromRow, FromCol, KingRow, KingCol).
+    square_attacked(Board, KingRow, KingCol, OpponentColor).
 
 % ======================
 % LEGAL MOVE (doesnt leave king in check)
 % ======================
 
 % A move is legal if it doesnt leave your own king in check
-legal_move(Board, Color, FromRow, FromCol, ToRow, ToCol) :-
+legal_move(Board0, Color, FromRow, FromCol, ToRow, ToCol) :-
+    board_term(Board0, Board),
     valid_move(Board, Color, FromRow, FromCol, ToRow, ToCol),
     execute_move(Board, FromRow, FromCol, ToRow, ToCol, NewBoard),
-    \+ in_check(NewBoard, Color).
+    \+ king_attacked(NewBoard, Color).
+
+% A generated move that doesnt leave your own king in check
+legal_target(Board, Color, Legality, FromRow, FromCol, ToRow, ToCol) :-
+    piece_at(Board, FromRow, FromCol, piece(Type, Color, FromRow, FromCol)),
+    piece_target(Board, Type, Color, FromRow, FromCol, ToRow, ToCol),
+    allowed(Legality, Type, FromRow, FromCol, ToRow, ToCol).
 
 % Get all legal moves
-all_legal_moves(Board, Color, Moves) :-
+all_legal_moves(Board0, Color, Moves) :-
+    board_term(Board0, Board),
+    legality(Board, Color, Legality),
     findall(
         move(FromRow, FromCol, ToRow, ToCol),
-        (
-            member(piece(_, Color, FromRow, FromCol), Board),
-            between(1, 8, ToRow),
-            between(1, 8, ToCol),
-            legal_move(Board, Color, FromRow, FromCol, ToRow, ToCol)
-        ),
+        legal_target(Board, Color, Legality, FromRow, FromCol, ToRow, ToCol),
         Moves
     ).
 
@@ -52,18 +267,18 @@ all_legal_moves(Board, Color, Moves) :-
 
 % Check if color has any legal move
 has_legal_move(Board, Color) :-
-    member(piece(_, Color, FromRow, FromCol), Board),
-    between(1, 8, ToRow),
-    between(1, 8, ToCol),
-    legal_move(Board, Color, FromRow, FromCol, ToRow, ToCol), !.
+    legality(Board, Color, Legality),
+    legal_target(Board, Color, Legality, _, _, _, _), !.
 
 % Checkmate: in check and no legal moves
-is_checkmate(Board, Color) :-
+is_checkmate(Board0, Color) :-
+    board_term(Board0, Board),
     in_check(Board, Color),
     \+ has_legal_move(Board, Color).
 
 % Stalemate: not in check but no legal moves
-is_stalemate(Board, Color) :-
+is_stalemate(Board0, Color) :-
+    board_term(Board0, Board),
     \+ in_check(Board, Color),
     \+ has_legal_move(Board, Color).
 
@@ -4,38 +4,38 @@
 :- [board_state].
 :- [piece_moves].
 
-% Execute a move: remove piece from old position, place at new position
-execute_move(OldBoard, FromRow, FromCol, ToRow, ToCol, NewBoard) :-
+% Execute a move: remove piece from old position, place at new position.
+% The new board is a copy with two arguments replaced; a captured piece
+% is simply overwritten.
+execute_move(OldBoard0, FromRow, FromCol, ToRow, ToCol, NewBoard) :-
+    board_term(OldBoard0, OldBoard),
+
     % Get the piece being moved
     piece_at(OldBoard, FromRow, FromCol, piece(Type, Color, FromRow, FromCol)),
-    
-    % Remove piece from old position
-    select(piece(Type, Color, FromRow, FromCol), OldBoard, TempBoard),
-    
-    % Remove any piece at destination (capture)
-    ( piece_at(TempBoard, ToRow, ToCol, CapturedPiece) ->
-        select(CapturedPiece, TempBoard, TempBoard2)
-    ;   TempBoard2 = TempBoard
-    ),
-    
-    % Add piece to new position
-    NewBoard = [piece(Type, Color, ToRow, ToCol) | TempBoard2].
+    on_board(ToRow, ToCol),
+
+    % Copy the board, empty the old square and fill the new one
+    duplicate_term(OldBoard, NewBoard),
+    square_index(FromRow, FromCol, FromIndex),
+    square_index(ToRow, ToCol, ToIndex),
+    setarg(FromIndex, NewBoard, empty),
+    setarg(ToIndex, NewBoard, piece(Type, Color)).
 
 % Get all valid moves for a given color
-all_valid_moves(Board, Color, Moves) :-
+all_valid_moves(Board0, Color, Moves) :-
+    board_term(Board0, Board),
     findall(
         move(FromRow, FromCol, ToRow, ToCol),
         (
-            member(piece(_, Color, FromRow, FromCol), Board),
-            between(1, 8, ToRow),
-            between(1, 8, ToCol),
-            valid_move(Board, Color, FromRow, FromCol, ToRow, ToCol)
+            piece_at(Board, FromRow, FromCol, piece(Type, Color, FromRow, FromCol)),
+            piece_target(Board, Type, Color, FromRow, FromCol, ToRow, ToCol)
         ),
         Moves
     ).
 
 % Display the board (for debugging)
-display_board(Board) :-
+display_board(Board0) :-
+    board_term(Board0, Board),
     nl,
     display_row(Board, 8),
     display_row(Board, 7),
@@ -89,16 +89,10 @@ path_clear(Board, FromRow, FromCol, ToRow, ToCol) :-
 % Base case: reached destination
 check_path(_, ToRow, ToCol, ToRow, ToCol, _, _).
 
-% Recursive case: keep checking path
+% Recursive case: keep checking path. A single clause, so a diagonal
+% path is proved once rather than twice.
 check_path(Board, CurrentRow, CurrentCol, ToRow, ToCol, RowDir, ColDir) :-
-    CurrentRow \= ToRow,  % Havent reached destination
-    is_empty(Board, CurrentRow, CurrentCol),  % Current square must be empty
-    NextRow is CurrentRow + RowDir,
-    NextCol is CurrentCol + ColDir,
-    check_path(Board, NextRow, NextCol, ToRow, ToCol, RowDir, ColDir).
-
-check_path(Board, CurrentRow, CurrentCol, ToRow, ToCol, RowDir, ColDir) :-
-    CurrentCol \= ToCol,  % Havent reached destination  
+    \+ (CurrentRow = ToRow, CurrentCol = ToCol),  % Havent reached destination
     is_empty(Board, CurrentRow, CurrentCol),  % Current square must be empty
     NextRow is CurrentRow + RowDir,
     NextCol is CurrentCol + ColDir,
@@ -108,7 +102,9 @@ check_path(Board, CurrentRow, CurrentCol, ToRow, ToCol, RowDir, ColDir) :-
 % MAIN MOVE VALIDATION
 % ======================
 
-valid_move(Board, Color, FromRow, FromCol, ToRow, ToCol) :-
+% Check one move with every square bound
+valid_move(Board0, Color, FromRow, FromCol, ToRow, ToCol) :-
+    board_term(Board0, Board),
     on_board(ToRow, ToCol),
     piece_at(Board, FromRow, FromCol, piece(Type, Color, FromRow, FromCol)),
     ( is_empty(Board, ToRow, ToCol) ; is_opponent(Board, ToRow, ToCol, Color) ),
@@ -118,4 +114,100 @@ valid_move(Board, Color, FromRow, FromCol, ToRow, ToCol) :-
     ; Type = bishop -> valid_bishop_move(Board, FromRow, FromCol, ToRow, ToCol)
     ; Type = queen  -> valid_queen_move(Board, FromRow, FromCol, ToRow, ToCol)
     ; Type = king   -> valid_king_move(FromRow, FromCol, ToRow, ToCol)
-    ).
\ No newline at end of file
+    ).
+
+% ======================
+% MOVE GENERATION
+% ======================
+
+% Enumerate the squares a piece can move to, following the same rules as
+% valid_move/6. Generating them directly visits only the reachable
+% squares instead of testing all 64.
+piece_target(Board, pawn, Color, FromRow, FromCol, ToRow, ToCol) :-
+    (Color = white -> Direction = 1 ; Direction = -1),
+    ToRow is FromRow + Direction,
+    (   ToCol = FromCol,
+        is_empty(Board, ToRow, ToCol)
+    ;   (ToCol is FromCol - 1 ; ToCol is FromCol + 1),
+        is_opponent(Board, ToRow, ToCol, Color)
+    ).
+piece_target(Board, pawn, Color, FromRow, FromCol, ToRow, FromCol) :-
+    (Color = white -> FromRow = 2, Direction = 1 ; FromRow = 7, Direction = -1),
+    MiddleRow is FromRow + Direction,
+    is_empty(Board, MiddleRow, FromCol),
+    ToRow is FromRow + 2 * Direction,
+    is_empty(Board, ToRow, FromCol).
+piece_target(Board, knight, Color, FromRow, FromCol, ToRow, ToCol) :-
+    knight_offset(RowStep, ColStep),
+    ToRow is FromRow + RowStep,
+    ToCol is FromCol + ColStep,
+    free_or_opponent(Board, ToRow, ToCol, Color).
+piece_target(Board, king, Color, FromRow, FromCol, ToRow, ToCol) :-
+    king_offset(RowStep, ColStep),
+    ToRow is FromRow + RowStep,
+    ToCol is FromCol + ColStep,
+    free_or_opponent(Board, ToRow, ToCol, Color).
+piece_target(Board, rook, Color, FromRow, FromCol, ToRow, ToCol) :-
+    rook_direction(RowDir, ColDir),
+    slide(Board, Color, FromRow, FromCol, RowDir, ColDir, ToRow, ToCol).
+piece_target(Board, bishop, Color, FromRow, FromCol, ToRow, ToCol) :-
+    bishop_direction(RowDir, ColDir),
+    slide(Board, Color, FromRow, FromCol, RowDir, ColDir, ToRow, ToCol).
+piece_target(Board, queen, Color, FromRow, FromCol, ToRow, ToCol) :-
+    ( rook_direction(RowDir, ColDir) ; bishop_direction(RowDir, ColDir) ),
+    slide(Board, Color, FromRow, FromCol, RowDir, ColDir, ToRow, ToCol).
+
+% Squares along one direction up to the first piece, which is included
+% if it belongs to the opponent
+slide(Board, Color, Row, Col, RowDir, ColDir, ToRow, ToCol) :-
+    NextRow is Row + RowDir,
+    NextCol is Col + ColDir,
+    on_board(NextRow, NextCol),
+    square(Board, NextRow, NextCol, Contents),
+    (   Contents == empty
+    ->  (   ToRow = NextRow, ToCol = NextCol
+        ;   slide(Board, Color, NextRow, NextCol, RowDir, ColDir, ToRow, ToCol)
+        )
+    ;   Contents = piece(_, Other),
+        Other \== Color,
+        ToRow = NextRow,
+        ToCol = NextCol
+    ).
+
+% An on-board square that is empty or holds an opponent's piece
+free_or_opponent(Board, Row, Col, Color) :-
+    on_board(Row, Col),
+    square(Board, Row, Col, Contents),
+    (   Contents == empty
+    ->  true
+    ;   Contents = piece(_, Other),
+        Other \== Color
+    ).
+
+knight_offset(2, 1).
+knight_offset(2, -1).
+knight_offset(-2, 1).
+knight_offset(-2, -1).
+knight_offset(1, 2).
+knight_offset(1, -2).
+knight_offset(-1, 2).
+knight_offset(-1, -2).
+
+king_offset(1, 0).
+king_offset(-1, 0).
+king_offset(0, 1).
+king_offset(0, -1).
+king_offset(1, 1).
+king_offset(1, -1).
+king_offset(-1, 1).
+king_offset(-1, -1).
+
+rook_direction(1, 0).
+rook_direction(-1, 0).
+rook_direction(0, 1).
+rook_direction(0, -1).
+
+bishop_direction(1, 1).
+bishop_direction(1, -1).
+bishop_direction(-1, 1).
+bishop_direction(-1, -1).
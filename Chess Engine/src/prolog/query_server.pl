@@ -0,0 +1,37 @@
+% query_server.pl
+% Long-running query loop used by the C++ PrologInterface
+%
+% Started once as: swipl -q -s query_server.pl -g serve -t halt
+% Each request is a single goal term terminated by a full stop and a
+% newline. Whatever the goal prints is followed by a line holding
+% only the end marker, so the caller knows where the answer stops.
+
+:- [check_detection].
+
+% ======================
+% REQUEST LOOP
+% ======================
+
+% Read goals until the input is closed
+serve :-
+    prompt(_, ''),
+    repeat,
+    read_term(user_input, Goal, []),
+    (   Goal == end_of_file
+    ->  !
+    ;   run_goal(Goal),
+        fail
+    ).
+
+% Run one goal, never letting a failure or error end the session
+run_goal(Goal) :-
+    (   catch(Goal, Error, (print_message(error, Error), fail))
+    ->  true
+    ;   true
+    ),
+    nl,
+    end_marker(Marker),
+    write(Marker), nl,
+    flush_output.
+
+end_marker('__END__').